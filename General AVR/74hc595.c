@@ -16,6 +16,10 @@ Comment:
 #include <avr/io.h>
 #include <inttypes.h>
 #include "74hc595.h"
+#if defined(__AVR_ATmega64__) || defined(__AVR_ATmega128__)
+	#include "atmega128spi.h"
+	#define HC595_SPI
+#endif
 /***Constant & Macro***/
 #ifndef GLOBAL_INTERRUPT_ENABLE
 	#define GLOBAL_INTERRUPT_ENABLE 7
@@ -31,6 +35,13 @@ uint8_t HC595_outpin;
 void HC595_shift_bit(uint8_t _bool);
 void HC595_shift_byte(uint8_t byte);
 void HC595_shift_out(void);
+#ifdef HC595_SPI
+void HC595SPI_set(HC595SPI* self, uint8_t index, uint8_t byte);
+uint8_t HC595SPI_get(HC595SPI* self, uint8_t index);
+void HC595SPI_pin(HC595SPI* self, uint8_t n, uint8_t _bool);
+void HC595SPI_update(HC595SPI* self);
+void HC595SPI_stream(HC595SPI* self, uint8_t index, const uint8_t* seq, uint8_t n);
+#endif
 /***Procedure & Function***/
 HC595 HC595enable(volatile uint8_t *ddr, volatile uint8_t *port, uint8_t datapin, uint8_t clkpin, uint8_t outpin)
 {
@@ -78,5 +89,81 @@ void HC595_shift_out(void)
 	*hc595_PORT |= (1<<HC595_outpin); //Output enable
 	*hc595_PORT &= ~(1<<HC595_outpin); //Output disable
 }
+/***/
+#ifdef HC595_SPI
+HC595SPI HC595SPIenable(SPI* spi, volatile uint8_t *ddr, volatile uint8_t *port, uint8_t outpin, uint8_t nregister)
+{
+	//LOCAL VARIABLES
+	uint8_t tSREG;
+	uint8_t i;
+	tSREG=SREG;
+	SREG&=~(1<<GLOBAL_INTERRUPT_ENABLE);
+	//ALLOCAÇÂO MEMORIA PARA Estrutura
+	HC595SPI hc595spi;
+	//import parametros
+	hc595spi.port=port;
+	hc595spi.outmask=(1<<outpin);
+	if(nregister > HC595_MAX_CHAIN)
+		nregister=HC595_MAX_CHAIN;
+	hc595spi.spi=spi;
+	hc595spi.nregister=nregister;
+	//inic variables
+	for(i=0;i<HC595_MAX_CHAIN;i++)
+		hc595spi.shadow[i]=ZERO;
+	*ddr |= (1<<outpin);
+	*hc595spi.port &= ~hc595spi.outmask;
+	//Direccionar apontadores para PROTOTIPOS
+	hc595spi.set=HC595SPI_set;
+	hc595spi.get=HC595SPI_get;
+	hc595spi.pin=HC595SPI_pin;
+	hc595spi.update=HC595SPI_update;
+	hc595spi.stream=HC595SPI_stream;
+	SREG=tSREG;
+	//
+	return hc595spi;
+}
+void HC595SPI_set(HC595SPI* self, uint8_t index, uint8_t byte)
+{
+	if(index < self->nregister)
+		self->shadow[self->nregister-1-index]=byte;
+}
+uint8_t HC595SPI_get(HC595SPI* self, uint8_t index)
+{
+	if(index < self->nregister)
+		return self->shadow[self->nregister-1-index];
+	return ZERO;
+}
+void HC595SPI_pin(HC595SPI* self, uint8_t n, uint8_t _bool)
+{
+	uint8_t* reg;
+	if((n>>3) >= self->nregister)
+		return;
+	reg=&self->shadow[self->nregister-1-(n>>3)];
+	if(_bool)
+		*reg |= (1<<(n & 7));
+	else
+		*reg &= ~(1<<(n & 7));
+}
+void HC595SPI_update(HC595SPI* self)
+{
+	self->spi->transmit_sync(self->shadow, self->nregister);
+	*self->port |= self->outmask; //Output enable
+	*self->port &= ~self->outmask; //Output disable
+}
+void HC595SPI_stream(HC595SPI* self, uint8_t index, const uint8_t* seq, uint8_t n)
+// latch each value of seq on register index, the rest of the chain is shifted unchanged
+{
+	uint8_t* reg;
+	if(index >= self->nregister)
+		return;
+	reg=&self->shadow[self->nregister-1-index];
+	for(; n; n--, seq++){
+		*reg=*seq;
+		self->spi->transmit_sync(self->shadow, self->nregister);
+		*self->port |= self->outmask;
+		*self->port &= ~self->outmask;
+	}
+}
+#endif
 /***Interrupt***/
 /***EOF***/
@@ -12,7 +12,11 @@ Comment:
 	#define _74HC595_H_
 /***Library***/
 #include <inttypes.h>
+struct sp; // SPI vtable, atmega128spi.h, only HC595SPI needs it
 /***Constant & Macro***/
+#ifndef HC595_MAX_CHAIN
+	#define HC595_MAX_CHAIN 8
+#endif
 /***Global Variable***/
 struct hc595{
 	/******/
@@ -21,7 +25,31 @@ struct hc595{
 	void (*out)(void);
 };
 typedef struct hc595 HC595;
+/***/
+struct hc595spi{
+	struct sp* spi;
+	volatile uint8_t* port; // latch
+	uint8_t outmask;
+	uint8_t nregister; // daisy chained registers
+	uint8_t shadow[HC595_MAX_CHAIN]; // wire order, last register first
+	/******/
+	void (*set)(struct hc595spi* self, uint8_t index, uint8_t byte);
+	uint8_t (*get)(struct hc595spi* self, uint8_t index);
+	void (*pin)(struct hc595spi* self, uint8_t n, uint8_t _bool);
+	void (*update)(struct hc595spi* self);
+	void (*stream)(struct hc595spi* self, uint8_t index, const uint8_t* seq, uint8_t n);
+};
+typedef struct hc595spi HC595SPI;
 /***Header***/
 HC595 HC595enable(volatile uint8_t *ddr, volatile uint8_t *port, uint8_t datapin, uint8_t clkpin, uint8_t outpin);
+HC595SPI HC595SPIenable(struct sp* spi, volatile uint8_t *ddr, volatile uint8_t *port, uint8_t outpin, uint8_t nregister);
 #endif
+/***Comment***
+HC595SPI clocks the whole chain from the shadow buffer over hardware SPI (MOSI to SER, SCK to SRCLK),
+only the latch pin is driven by hand. Enable SPI in master mode with LSB data order to match the bit
+banged backend, index 0 is the register wired to the MCU, index or pin past the chain is ignored (get
+returns 0). At SPI clock F_CPU/2 one register takes 1us. stream latches n successive values of register
+index in one call, shift and latch back to back, for strobed parallel devices like the HD44780 EN. HC595SPI is built only where the SPI library
+exists (ATmega64/128), the bit banged HC595 builds on every part.
+*************/
 /***EOF***/
@@ -0,0 +1,147 @@
+/*************************************************************************
+	ABRECORD
+Author: Sergio Santos
+	<sergio.salazar.santos@gmail.com>
+License: GNU General Public License
+Hardware: ATmega
+Date: 17102026
+Comment:
+	Double buffered crc protected record over EEPROM vtable
+************************************************************************/
+/***Library***/
+#include <inttypes.h>
+#include "abrecord.h"
+#include "crc.h"
+/***Constant & Macro***/
+#define ZERO 0
+#define ONE 1
+#define ABRECORD_CHUNK 16
+/***Global File Variable***/
+CRC abrecord_crc;
+/***Header***/
+uint8_t ABRECORD_load(ABRECORD* self, void* data);
+uint8_t ABRECORD_commit(ABRECORD* self, const void* data);
+uint8_t ABRECORD_getactive(ABRECORD* self);
+uint16_t ABRECORD_copy(ABRECORD* self, uint8_t copy);
+uint8_t ABRECORD_check(ABRECORD* self, uint8_t copy, struct abheader* header);
+uint8_t ABRECORD_same(ABRECORD* self, const void* data);
+/***Procedure & Function***/
+ABRECORD ABRECORDenable(EEPROM* eeprom, uint16_t addr, uint16_t size)
+{
+	//ALLOCAÇÂO MEMORIA PARA Estrutura
+	ABRECORD ab;
+	struct abheader a, b;
+	uint8_t va, vb;
+	abrecord_crc=CRCenable();
+	//import parametros
+	ab.eprom=eeprom;
+	ab.addr=addr;
+	ab.size=size;
+	//Direccionar apontadores para PROTOTIPOS
+	ab.load=ABRECORD_load;
+	ab.commit=ABRECORD_commit;
+	ab.getactive=ABRECORD_getactive;
+	//inic variables, newest valid copy
+	va=ABRECORD_check(&ab, ZERO, &a);
+	vb=ABRECORD_check(&ab, ONE, &b);
+	if(va && vb)
+		ab.active=((int16_t)(b.seq - a.seq) > 0) ? ONE : ZERO;
+	else if(va)
+		ab.active=ZERO;
+	else if(vb)
+		ab.active=ONE;
+	else
+		ab.active=ABRECORD_NONE;
+	switch(ab.active){
+		case ZERO:
+			ab.seq=a.seq;
+			ab.crc=a.crc;
+			break;
+		case ONE:
+			ab.seq=b.seq;
+			ab.crc=b.crc;
+			break;
+		default:
+			ab.seq=ZERO;
+			ab.crc=ZERO;
+			break;
+	}
+	//
+	return ab;
+}
+uint8_t ABRECORD_load(ABRECORD* self, void* data)
+{
+	if(self->active == ABRECORD_NONE)
+		return ZERO;
+	self->eprom->read_block(data, (const void*)(ABRECORD_copy(self, self->active)+sizeof(struct abheader)), self->size);
+	return ONE;
+}
+uint8_t ABRECORD_commit(ABRECORD* self, const void* data)
+{
+	struct abheader header;
+	uint8_t copy;
+	uint16_t addr;
+	header.seq=self->seq+ONE;
+	if(self->active != ABRECORD_NONE)
+		if(ABRECORD_same(self, data))
+			return ONE;
+	copy=(self->active == ZERO) ? ONE : ZERO;
+	addr=ABRECORD_copy(self, copy);
+	header.crc=abrecord_crc.crc16(CRC16_INIT, &header.seq, sizeof(header.seq));
+	header.crc=abrecord_crc.crc16(header.crc, data, self->size);
+	self->eprom->update_block(data, (void*)(addr+sizeof(struct abheader)), self->size);
+	self->eprom->update_block(&header, (void*)addr, sizeof(struct abheader));
+	self->active=copy;
+	self->seq=header.seq;
+	self->crc=header.crc;
+	return ONE;
+}
+uint8_t ABRECORD_getactive(ABRECORD* self)
+{
+	return self->active;
+}
+uint16_t ABRECORD_copy(ABRECORD* self, uint8_t copy)
+{
+	return self->addr + copy*(self->size+sizeof(struct abheader));
+}
+uint8_t ABRECORD_check(ABRECORD* self, uint8_t copy, struct abheader* header)
+/***
+crc of copy computed in chunks, no buffer of record size
+***/
+{
+	uint8_t chunk[ABRECORD_CHUNK];
+	uint16_t addr, n, crc;
+	addr=ABRECORD_copy(self, copy);
+	self->eprom->read_block(header, (const void*)addr, sizeof(struct abheader));
+	addr+=sizeof(struct abheader);
+	crc=abrecord_crc.crc16(CRC16_INIT, &header->seq, sizeof(header->seq));
+	for(n=self->size; n; ){
+		uint16_t len=(n > ABRECORD_CHUNK) ? ABRECORD_CHUNK : n;
+		self->eprom->read_block(chunk, (const void*)addr, len);
+		crc=abrecord_crc.crc16(crc, chunk, len);
+		addr+=len;
+		n-=len;
+	}
+	return crc == header->crc;
+}
+uint8_t ABRECORD_same(ABRECORD* self, const void* data)
+/***
+active copy compared byte by byte in chunks, a crc match could hide a change
+***/
+{
+	uint8_t chunk[ABRECORD_CHUNK];
+	const uint8_t* src=(const uint8_t*)data;
+	uint16_t addr, n, len, i;
+	addr=ABRECORD_copy(self, self->active)+sizeof(struct abheader);
+	for(n=self->size; n; n-=len){
+		len=(n > ABRECORD_CHUNK) ? ABRECORD_CHUNK : n;
+		self->eprom->read_block(chunk, (const void*)addr, len);
+		for(i=ZERO;i<len;i++)
+			if(chunk[i] != *src++)
+				return ZERO;
+		addr+=len;
+	}
+	return ONE;
+}
+/***Interrupt***/
+/***EOF***/
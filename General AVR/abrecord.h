@@ -0,0 +1,45 @@
+/************************************************************************
+	ABRECORD
+Author: Sergio Santos
+	<sergio.salazar.santos@gmail.com>
+License: GNU General Public License
+Hardware: ATmega
+Date: 17102026
+Comment:
+	Double buffered crc protected record over EEPROM vtable
+************************************************************************/
+#ifndef _ABRECORD_H_
+	#define _ABRECORD_H_
+/***Library***/
+#include <inttypes.h>
+#include "eeprom.h"
+/***Constant & Macro***/
+#define ABRECORD_NONE 0xFF
+/***Global Variable***/
+struct abheader{
+	uint16_t seq;
+	uint16_t crc; // crc16 of seq and data
+};
+struct abrecord{
+	EEPROM* eprom;
+	uint16_t addr; // copy A, copy B follows
+	uint16_t size; // data bytes
+	uint16_t seq; // sequence of active copy
+	uint16_t crc; // crc of active copy
+	uint8_t active; // 0 A, 1 B, ABRECORD_NONE if no valid copy
+	/******/
+	uint8_t (*load)(struct abrecord* self, void* data);
+	uint8_t (*commit)(struct abrecord* self, const void* data);
+	uint8_t (*getactive)(struct abrecord* self);
+};
+typedef struct abrecord ABRECORD;
+/***Header***/
+ABRECORD ABRECORDenable(EEPROM* eeprom, uint16_t addr, uint16_t size);
+#endif
+/***Comment***
+Uses 2*(size+4) bytes of eeprom starting at addr. commit writes the copy that is not active, data first
+and header last, through update_block so only the bytes that changed since that copy was last written
+are programmed, and returns without writing when data equals the active copy. A brown-out in the middle
+leaves that copy with a bad crc, load at boot then takes the other one, the last complete commit.
+*************/
+/***EOF***/
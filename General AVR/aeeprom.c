@@ -0,0 +1,265 @@
+/*************************************************************************
+	Asynchronous eeprom
+Author: Sergio Santos
+	<sergio.salazar.santos@gmail.com>
+License: GNU General Public License
+Hardware: ATmega
+Date: 17102026
+Comment:
+	Writes queued in RAM and drained by EE_READY interrupt
+*************************************************************************/
+/***Library***/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "aeeprom.h"
+/***Constant & Macro***/
+#define ZERO 0
+#define ONE 1
+#ifndef GLOBAL_INTERRUPT_ENABLE
+	#define GLOBAL_INTERRUPT_ENABLE 7
+#endif
+/***ATmega8/16/32/64/128 name the write strobes EEWE and EEMWE***/
+#ifndef EEPE
+	#define EEPE EEWE
+	#define EEMPE EEMWE
+#endif
+#define AEEPROM_QUEUE_MASK (AEEPROM_QUEUE_SIZE - 1)
+#if ( AEEPROM_QUEUE_SIZE & AEEPROM_QUEUE_MASK )
+	#error AEEPROM queue size is not a power of 2
+#endif
+#if ( AEEPROM_QUEUE_SIZE > 256 )
+	#error AEEPROM queue size larger than 256
+#endif
+/***Global File Variable***/
+struct aeeprom_entry{
+	uint16_t addr;
+	uint8_t data;
+};
+static volatile struct aeeprom_entry AEEPROM_Queue[AEEPROM_QUEUE_SIZE];
+static volatile uint8_t AEEPROM_Head;
+static volatile uint8_t AEEPROM_Tail;
+static uint16_t AEEPROM_FlightAddr; // byte being programmed, valid while EEPE
+static uint8_t AEEPROM_FlightData;
+/***Header***/
+uint8_t AEEPROM_read_byte(const uint8_t* addr);
+void AEEPROM_write_byte(uint8_t* addr, uint8_t value);
+uint16_t AEEPROM_read_word(const uint16_t* addr);
+void AEEPROM_write_word(uint16_t* addr, uint16_t value);
+uint32_t AEEPROM_read_dword(const uint32_t* addr);
+void AEEPROM_write_dword(uint32_t* addr, uint32_t value);
+float AEEPROM_read_float(const float* addr);
+void AEEPROM_write_float(float* addr, float value);
+void AEEPROM_read_block(void* pointer_ram, const void* pointer_eeprom, size_t n);
+void AEEPROM_write_block(const void* pointer_ram, void* pointer_eeprom, size_t n);
+void AEEPROM_flush(void);
+uint8_t AEEPROM_pending(void);
+void AEEPROM_push(uint16_t addr, uint8_t data);
+uint8_t AEEPROM_program(void);
+uint8_t AEEPROM_overlay(uint8_t* dst, uint16_t addr, size_t n, uint8_t flight);
+/***Procedure & Function***/
+EEPROM AEEPROMenable(void)
+{
+	EEPROM eprom;
+	AEEPROM_Head=0;
+	AEEPROM_Tail=0;
+	EECR&=~(1<<EERIE);
+	/***update is done by the interrupt, both map to the same queue***/
+	eprom.read_byte=AEEPROM_read_byte;
+	eprom.write_byte=AEEPROM_write_byte;
+	eprom.update_byte=AEEPROM_write_byte;
+	eprom.read_word=AEEPROM_read_word;
+	eprom.write_word=AEEPROM_write_word;
+	eprom.update_word=AEEPROM_write_word;
+	eprom.read_dword=AEEPROM_read_dword;
+	eprom.write_dword=AEEPROM_write_dword;
+	eprom.update_dword=AEEPROM_write_dword;
+	eprom.read_float=AEEPROM_read_float;
+	eprom.write_float=AEEPROM_write_float;
+	eprom.update_float=AEEPROM_write_float;
+	eprom.read_block=AEEPROM_read_block;
+	eprom.write_block=AEEPROM_write_block;
+	eprom.update_block=AEEPROM_write_block;
+	eprom.flush=AEEPROM_flush;
+	eprom.pending=AEEPROM_pending;
+	return eprom;
+}
+uint8_t AEEPROM_read_byte(const uint8_t* addr)
+{
+	uint8_t value;
+	AEEPROM_read_block(&value, addr, 1);
+	return value;
+}
+void AEEPROM_write_byte(uint8_t* addr, uint8_t value)
+{
+	AEEPROM_push((uint16_t)addr, value);
+}
+uint16_t AEEPROM_read_word(const uint16_t* addr)
+{
+	uint16_t value;
+	AEEPROM_read_block(&value, addr, sizeof(value));
+	return value;
+}
+void AEEPROM_write_word(uint16_t* addr, uint16_t value)
+{
+	AEEPROM_write_block(&value, addr, sizeof(value));
+}
+uint32_t AEEPROM_read_dword(const uint32_t* addr)
+{
+	uint32_t value;
+	AEEPROM_read_block(&value, addr, sizeof(value));
+	return value;
+}
+void AEEPROM_write_dword(uint32_t* addr, uint32_t value)
+{
+	AEEPROM_write_block(&value, addr, sizeof(value));
+}
+float AEEPROM_read_float(const float* addr)
+{
+	float value;
+	AEEPROM_read_block(&value, addr, sizeof(value));
+	return value;
+}
+void AEEPROM_write_float(float* addr, float value)
+{
+	AEEPROM_write_block(&value, addr, sizeof(value));
+}
+void AEEPROM_read_block(void* pointer_ram, const void* pointer_eeprom, size_t n)
+{
+	uint8_t* dst=(uint8_t*)pointer_ram;
+	uint16_t addr=(uint16_t)pointer_eeprom;
+	uint16_t offset;
+	uint8_t tSREG;
+	tSREG=SREG;
+	SREG&=~(1<<GLOBAL_INTERRUPT_ENABLE);
+	/***hold the interrupt off so EEAR stays ours***/
+	EECR&=~(1<<EERIE);
+	/***array is not readable while a byte programs, unless RAM holds every byte asked for***/
+	if(!(EECR & (1<<EEPE)) || !AEEPROM_overlay(dst, addr, n, ONE)){
+		SREG=tSREG;
+		while(EECR & (1<<EEPE))
+			; // one byte at most, no new one starts
+		for(offset=ZERO; offset<n; offset++){
+			EEAR=addr+offset;
+			EECR|=(1<<EERE);
+			dst[offset]=EEDR;
+		}
+		SREG&=~(1<<GLOBAL_INTERRUPT_ENABLE);
+		AEEPROM_overlay(dst, addr, n, ZERO);
+	}
+	if(AEEPROM_Head != AEEPROM_Tail)
+		EECR|=(1<<EERIE);
+	SREG=tSREG;
+}
+uint8_t AEEPROM_overlay(uint8_t* dst, uint16_t addr, size_t n, uint8_t flight)
+/***
+Queued bytes are newer than eeprom, copied oldest to newest, the byte being programmed before them.
+Interrupts disabled. Returns 1 when every byte of a read of up to 32 bytes came from RAM.
+***/
+{
+	uint32_t mask=ZERO;
+	uint16_t offset;
+	uint8_t i;
+	if(flight){
+		offset=AEEPROM_FlightAddr-addr;
+		if(offset < n){
+			dst[offset]=AEEPROM_FlightData;
+			if(offset < 32)
+				mask|=(1UL<<offset);
+		}
+	}
+	for(i=AEEPROM_Tail; i!=AEEPROM_Head; i=(i+1) & AEEPROM_QUEUE_MASK){
+		offset=AEEPROM_Queue[i].addr-addr;
+		if(offset < n){
+			dst[offset]=AEEPROM_Queue[i].data;
+			if(offset < 32)
+				mask|=(1UL<<offset);
+		}
+	}
+	return (n && n <= 32 && mask == (0xFFFFFFFFUL>>(32-n))) ? ONE : ZERO;
+}
+void AEEPROM_write_block(const void* pointer_ram, void* pointer_eeprom, size_t n)
+{
+	const uint8_t* src=(const uint8_t*)pointer_ram;
+	uint16_t addr=(uint16_t)pointer_eeprom;
+	for(; n; n--)
+		AEEPROM_push(addr++, *src++);
+}
+void AEEPROM_flush(void)
+{
+	while(AEEPROM_Head != AEEPROM_Tail){
+		if(!(SREG & (1<<GLOBAL_INTERRUPT_ENABLE)))
+			AEEPROM_program();
+	}
+	while(EECR & (1<<EEPE))
+		;
+}
+uint8_t AEEPROM_pending(void)
+{
+	return ((AEEPROM_Head - AEEPROM_Tail) & AEEPROM_QUEUE_MASK) + ((EECR & (1<<EEPE)) ? 1 : 0);
+}
+void AEEPROM_push(uint16_t addr, uint8_t data)
+{
+	uint8_t i;
+	uint8_t n;
+	uint8_t tmphead;
+	uint8_t tSREG;
+	tSREG=SREG;
+	SREG&=~(1<<GLOBAL_INTERRUPT_ENABLE);
+	/***coalesce with a recent queued byte for same address, newest first***/
+	for(i=AEEPROM_Head, n=AEEPROM_COALESCE; n && i!=AEEPROM_Tail; n--){
+		i=(i-1) & AEEPROM_QUEUE_MASK;
+		if(AEEPROM_Queue[i].addr == addr){
+			AEEPROM_Queue[i].data=data;
+			SREG=tSREG;
+			return;
+		}
+	}
+	tmphead=(AEEPROM_Head + 1) & AEEPROM_QUEUE_MASK;
+	while(tmphead == AEEPROM_Tail){
+		/***queue full***/
+		if(tSREG & (1<<GLOBAL_INTERRUPT_ENABLE)){
+			SREG=tSREG;
+			while(tmphead == AEEPROM_Tail)
+				;
+			SREG&=~(1<<GLOBAL_INTERRUPT_ENABLE);
+		}else
+			AEEPROM_program();
+	}
+	AEEPROM_Queue[AEEPROM_Head].addr=addr;
+	AEEPROM_Queue[AEEPROM_Head].data=data;
+	AEEPROM_Head=tmphead;
+	EECR|=(1<<EERIE);
+	SREG=tSREG;
+}
+uint8_t AEEPROM_program(void)
+/***
+Program oldest queued byte that differs from eeprom, interrupts disabled.
+Returns 1 when a write was started.
+***/
+{
+	uint8_t tail;
+	while(EECR & (1<<EEPE))
+		;
+	for(tail=AEEPROM_Tail; tail != AEEPROM_Head; tail=(tail+1) & AEEPROM_QUEUE_MASK){
+		EEAR=AEEPROM_Queue[tail].addr;
+		EECR|=(1<<EERE);
+		if(EEDR != AEEPROM_Queue[tail].data){
+			EEDR=AEEPROM_Queue[tail].data;
+			AEEPROM_FlightAddr=AEEPROM_Queue[tail].addr;
+			AEEPROM_FlightData=AEEPROM_Queue[tail].data;
+			EECR|=(1<<EEMPE);
+			EECR|=(1<<EEPE);
+			AEEPROM_Tail=(tail+1) & AEEPROM_QUEUE_MASK;
+			return 1;
+		}
+	}
+	AEEPROM_Tail=tail;
+	EECR&=~(1<<EERIE);
+	return 0;
+}
+/***Interrupt***/
+ISR(EE_READY_vect)
+{
+	AEEPROM_program();
+}
+/***EOF***/
@@ -0,0 +1,43 @@
+/*************************************************************************
+	Asynchronous eeprom
+Author: Sergio Santos
+	<sergio.salazar.santos@gmail.com>
+License: GNU General Public License
+Hardware: ATmega
+Date: 17102026
+Comment:
+	Writes queued in RAM and drained by EE_READY interrupt
+*************************************************************************/
+#ifndef AEEPROM_H
+	#define AEEPROM_H
+/**@{*/
+#if (__GNUC__ * 100 + __GNUC_MINOR__) < 304
+	#error "This library requires AVR-GCC 3.4 or later, update to newer AVR-GCC compiler !"
+#endif
+/***Library***/
+#include "eeprom.h"
+/***Constant & Macro***/
+/***Size of the write queue in bytes, must be power of 2***/
+#ifndef AEEPROM_QUEUE_SIZE
+	#define AEEPROM_QUEUE_SIZE 64
+#endif
+/***Queued bytes looked at for coalescing, bounds the time with interrupts off***/
+#ifndef AEEPROM_COALESCE
+	#define AEEPROM_COALESCE 8
+#endif
+/***Global Variable***/
+/***Header***/
+EEPROM AEEPROMenable(void);
+#endif
+/***Comment***
+Same EEPROM vtable, write and update calls return as soon as the bytes are queued, the EE_READY
+interrupt programs one byte per ready event and skips bytes that already hold the value. A byte queued
+again within the last AEEPROM_COALESCE entries is coalesced in place, an older copy stays queued and is
+programmed first, so the newest value always ends in eeprom. Reads overlay the queued bytes so the
+caller always sees its own writes. A read checks EEPE once: with no byte programming it reads the array
+straight away, with one programming the array cannot be read, the read is served from RAM when the
+queue and that byte hold all of it (up to 32 bytes), else it waits for that one byte, up to 3.4ms.
+flush is the barrier, it returns when every queued byte is in eeprom. When the queue is full the write
+call waits for the interrupt to free a slot, with global interrupts off it programs the oldest byte itself.
+*************/
+/***EOF***/
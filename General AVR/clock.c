@@ -13,10 +13,19 @@ Comment:
 #include <inttypes.h>
 #include "clock.h"
 /***Constant & Macro***/
+#ifndef GLOBAL_INTERRUPT_ENABLE
+	#define GLOBAL_INTERRUPT_ENABLE 7
+#endif
 /***Global File Variable***/
+struct CLOCK_deadline{
+	uint32_t second;
+	uint8_t id;
+};
 struct TIME time;
-struct TIME laptime;
-struct TIME alarmtime;
+volatile uint32_t CLOCK_count;
+uint32_t CLOCK_shown;
+struct CLOCK_deadline CLOCK_list[CLOCK_DEADLINE_MAX];
+uint8_t CLOCK_nlist;
 char CLOCK_timp[9];
 uint8_t CLOCK_alarm_flag;
 uint8_t CLOCK_compare_active;
@@ -31,13 +40,17 @@ void CLOCK_second_count_stop(void);
 void CLOCK_alarm_reset(void);
 void CLOCK_alarm_stop(void);
 char* CLOCK_show(void);
+uint32_t CLOCK_seconds(void);
+void CLOCK_insert(uint8_t id, uint32_t second);
+void CLOCK_remove(uint8_t id);
+void CLOCK_fire(uint8_t id);
 /***Procedure & Function***/
 CLOCK CLOCKenable(uint8_t hour, uint8_t minute, uint8_t second)
 {
 	CLOCK clock;
-	time.hour=hour;
-	time.minute=minute;
-	time.second=second;
+	CLOCK_count=(uint32_t)hour*3600+(uint16_t)minute*60+second;
+	CLOCK_shown=~CLOCK_count;
+	CLOCK_nlist=0;
 	CLOCK_alarm_flag=0X0F;
 	CLOCK_compare_active=0X0F;
 	clock.set=CLOCK_set;
@@ -50,154 +63,172 @@ CLOCK CLOCKenable(uint8_t hour, uint8_t minute, uint8_t second)
 	clock.alarm_reset=CLOCK_alarm_reset;
 	clock.alarm_stop=CLOCK_alarm_stop;
 	clock.show=CLOCK_show;
+	clock.seconds=CLOCK_seconds;
 	return clock;
 }
 void CLOCK_set(uint8_t hour, uint8_t minute, uint8_t second)
+// alarm keeps its time of day, second_count the seconds it had to go
 {
-	time.hour=hour;
-	time.minute=minute;
-	time.second=second;
+	uint8_t i, tSREG=SREG;
+	uint32_t then, now, alarm=0, lap=0;
+	SREG&=~(1<<GLOBAL_INTERRUPT_ENABLE);
+	then=CLOCK_count;
+	now=then-(then % CLOCK_DAY)+(uint32_t)hour*3600+(uint16_t)minute*60+second; // keep day
+	CLOCK_count=now;
+	for(i=0;i<CLOCK_nlist;i++)
+		if(CLOCK_list[i].id == CLOCK_ALARM)
+			alarm=CLOCK_list[i].second;
+		else
+			lap=CLOCK_list[i].second;
+	if(CLOCK_alarm_flag == 4){
+		alarm=now-(now % CLOCK_DAY)+alarm % CLOCK_DAY;
+		if(alarm <= now)
+			alarm+=CLOCK_DAY; // tomorrow
+		CLOCK_insert(CLOCK_ALARM, alarm);
+	}
+	if(CLOCK_compare_active == 4)
+		CLOCK_insert(CLOCK_LAP, lap+(now-then));
+	SREG=tSREG;
 }
 void CLOCK_increment(void)
 {
-	time.second++;
-	if(time.second>59){
-		time.minute++;
-		time.second=0;
-		if(time.minute>59){
-			time.hour++;
-			time.minute=0;
-			switch (HORA){
-				case 24:
-					if(time.hour>23)
-						time.hour=0;
-					break;
-				case 12:
-					if (time.hour>12)
-						time.hour=1;
-					break;
-				default:
-					if(time.hour>23)
-						time.hour=0;
-					break;
-			}
-		}
-	}
-	/******************************************************************************************************************/
-	if(time.hour==laptime.hour && CLOCK_compare_active==4)
-		CLOCK_compare_active=3;
-	if(time.hour==laptime.hour && time.minute==laptime.minute && CLOCK_compare_active==3)
-		CLOCK_compare_active=2;
-	if(time.hour==laptime.hour && time.minute==laptime.minute && time.second==laptime.second && CLOCK_compare_active==2)
-		CLOCK_compare_active=1;
-	/******************************************************************************************************************/
-	if(time.hour==alarmtime.hour && CLOCK_alarm_flag==4)
-		CLOCK_alarm_flag=3;
-	if(time.hour==alarmtime.hour && time.minute==alarmtime.minute && CLOCK_alarm_flag==3)
-		CLOCK_alarm_flag=2;
-	if(time.hour==alarmtime.hour && time.minute==alarmtime.minute && time.second==alarmtime.second && CLOCK_alarm_flag==2)
-		CLOCK_alarm_flag=1;
+	CLOCK_count++;
+	while(CLOCK_nlist && CLOCK_list[0].second <= CLOCK_count)
+		CLOCK_fire(CLOCK_list[0].id);
 }
 void CLOCK_decrement(void)
+// alarm is a time of day, reached from either side, second_count only on its exact second
 {
-	time.second--;
-	if(time.second<0){
-		time.minute--;
-		time.second=59;
-		if(time.minute<0){
-			time.hour--;
-			time.minute=59;
-			switch (HORA){
-				case 24:
-					if(time.hour<0)
-						time.hour=23;
-					break;
-				case 12:
-					if (time.hour<1)
-						time.hour=12;
-					break;
-				default:
-					if(time.hour<0)
-						time.hour=23;
-					break;
-			}
+	uint8_t i;
+	uint32_t tod;
+	if(CLOCK_count)
+		CLOCK_count--;
+	else
+		CLOCK_count=CLOCK_DAY-1;
+	tod=CLOCK_count % CLOCK_DAY;
+	for(i=0;i<CLOCK_nlist;i++)
+		if((CLOCK_list[i].id == CLOCK_ALARM) ? (CLOCK_list[i].second % CLOCK_DAY == tod) : (CLOCK_list[i].second == CLOCK_count)){
+			CLOCK_fire(CLOCK_list[i].id);
+			break;
 		}
-	}
-	/******************************************************************************************************************/
-	if(time.hour==alarmtime.hour && CLOCK_alarm_flag==4)
-		CLOCK_alarm_flag=3;
-	if(time.hour==alarmtime.hour && time.minute==alarmtime.minute && CLOCK_alarm_flag==3)
-		CLOCK_alarm_flag=2;
-	if(time.hour==alarmtime.hour && time.minute==alarmtime.minute && time.second==alarmtime.second && CLOCK_alarm_flag==2)
-		CLOCK_alarm_flag=1;		
 }
 uint8_t CLOCK_alarm(uint8_t hour, uint8_t minute, uint8_t second)
 {
+	uint32_t now, deadline;
 	if(!CLOCK_alarm_flag){
-		alarmtime.hour=hour;
-		alarmtime.minute=minute;
-		alarmtime.second=second;
+		now=CLOCK_seconds();
+		deadline=now-(now % CLOCK_DAY)+(uint32_t)hour*3600+(uint16_t)minute*60+second;
+		if(deadline <= now)
+			deadline+=CLOCK_DAY; // tomorrow
 		CLOCK_alarm_flag=4;
+		CLOCK_insert(CLOCK_ALARM, deadline);
 	}
 	return CLOCK_alarm_flag;
 }
 uint8_t CLOCK_second_count(uint16_t second)
 {
-	uint16_t tmp;
-	uint8_t tmp_1;
-	uint8_t tmp_2;
-	uint8_t tmp_3;
 	if(!CLOCK_compare_active){
-		tmp_3=(int8_t)(second % 60);
-		tmp=second/60;
-		tmp_2=(int8_t)(tmp % 60);
-		tmp=tmp/60;
-		tmp_1=(int8_t)tmp;
-		laptime.second=(time.second + tmp_3) % 60;
-		tmp_3=(time.second + tmp_3)/60;
-		laptime.minute=(time.minute + tmp_2 + tmp_3) % 60;
-		tmp_2=(time.minute + tmp_2 + tmp_3)/60;
-		tmp_1=time.hour+ tmp_1 + tmp_2;
-		if(tmp_1 > HORA)
-			laptime.hour=HORA-tmp_1;
-		else
-			laptime.hour=tmp_1;
 		CLOCK_compare_active=4;
+		CLOCK_insert(CLOCK_LAP, CLOCK_seconds()+second);
 	}
 	return CLOCK_compare_active;
 }
 void CLOCK_alarm_reset(void)
 {
+	CLOCK_remove(CLOCK_ALARM);
 	CLOCK_alarm_flag=0;
 }
 void CLOCK_alarm_stop(void)
 {
+	CLOCK_remove(CLOCK_ALARM);
 	CLOCK_alarm_flag=0X0F;
 }
 void CLOCK_second_count_reset(void)
 {
+	CLOCK_remove(CLOCK_LAP);
 	CLOCK_compare_active=0;
 }
 void CLOCK_second_count_stop(void)
 {
+	CLOCK_remove(CLOCK_LAP);
 	CLOCK_compare_active=0X0F;
 }
 char* CLOCK_show(void)
 {
-	uint8_t tmp;
+	uint32_t now=CLOCK_seconds();
+	uint16_t tmp;
+	if(now == CLOCK_shown)
+		return CLOCK_timp; // same second, same string
+	CLOCK_shown=now;
+	/***fields only worked out here***/
+	now%=CLOCK_DAY;
+	time.hour=now/3600;
+	tmp=now-(uint32_t)time.hour*3600;
+	time.minute=tmp/60;
+	time.second=tmp-time.minute*60;
+	if(HORA == 12){
+		time.hour%=12;
+		if(!time.hour)
+			time.hour=12;
+	}
 	CLOCK_timp[8]='\0';
 	CLOCK_timp[7]=time.second % 10 + '0';
-	tmp = time.second / 10;
-	CLOCK_timp[6]=tmp % 10 + '0';
+	CLOCK_timp[6]=time.second / 10 + '0';
 	CLOCK_timp[5]=':';
 	CLOCK_timp[4]=time.minute % 10 + '0';
-	tmp = time.minute / 10;
-	CLOCK_timp[3]=tmp % 10 + '0';
+	CLOCK_timp[3]=time.minute / 10 + '0';
 	CLOCK_timp[2]=':';
 	CLOCK_timp[1]=time.hour % 10 + '0';
-	tmp = time.hour / 10;
-	CLOCK_timp[0]=tmp % 10 + '0';
+	CLOCK_timp[0]=time.hour / 10 + '0';
 	return CLOCK_timp;
 }
+uint32_t CLOCK_seconds(void)
+// 32 bit read is not atomic on the mcu
+{
+	uint32_t now;
+	uint8_t tSREG=SREG;
+	SREG&=~(1<<GLOBAL_INTERRUPT_ENABLE);
+	now=CLOCK_count;
+	SREG=tSREG;
+	return now;
+}
+void CLOCK_insert(uint8_t id, uint32_t second)
+// keep list sorted, earliest first
+{
+	uint8_t i;
+	uint8_t tSREG=SREG;
+	SREG&=~(1<<GLOBAL_INTERRUPT_ENABLE);
+	CLOCK_remove(id);
+	if(CLOCK_nlist < CLOCK_DEADLINE_MAX){
+		for(i=CLOCK_nlist;i && CLOCK_list[i-1].second > second;i--)
+			CLOCK_list[i]=CLOCK_list[i-1];
+		CLOCK_list[i].second=second;
+		CLOCK_list[i].id=id;
+		CLOCK_nlist++;
+	}
+	SREG=tSREG;
+}
+void CLOCK_remove(uint8_t id)
+{
+	uint8_t i, j;
+	uint8_t tSREG=SREG;
+	SREG&=~(1<<GLOBAL_INTERRUPT_ENABLE);
+	for(i=0;i<CLOCK_nlist;i++)
+		if(CLOCK_list[i].id == id){
+			for(j=i+1;j<CLOCK_nlist;j++)
+				CLOCK_list[j-1]=CLOCK_list[j];
+			CLOCK_nlist--;
+			break;
+		}
+	SREG=tSREG;
+}
+void CLOCK_fire(uint8_t id)
+{
+	CLOCK_remove(id);
+	if(id == CLOCK_ALARM)
+		CLOCK_alarm_flag=1;
+	else
+		CLOCK_compare_active=1;
+}
 /***Interrupt***/
 /***EOF***/
@@ -18,6 +18,12 @@ Comment:
 #include <inttypes.h>
 /***Constant & Macro***/
 #define HORA 24
+#define CLOCK_DAY 86400UL
+#ifndef CLOCK_DEADLINE_MAX
+	#define CLOCK_DEADLINE_MAX 4
+#endif
+#define CLOCK_LAP 0
+#define CLOCK_ALARM 1
 /***Global Variable***/
 struct TIME{
 	int8_t hour;
@@ -35,9 +41,22 @@ struct clck{
 	void (*alarm_reset)(void);
 	void (*alarm_stop)(void);
 	char* (*show)(void);
+	uint32_t (*seconds)(void);
 };
 typedef struct clck CLOCK;
 /***Header***/
 CLOCK CLOCKenable(uint8_t hour, uint8_t minute, uint8_t second);
 #endif
+/***Comment***
+Time is one 32 bit count of seconds, increment and decrement only add or subtract one and look at the
+first entry of a deadline list sorted by second, hour minute and second are worked out only when show
+is called, once per second, the string is kept until the count changes. alarm sets the next time the
+clock reads hour:minute:second, second_count a deadline second seconds ahead, both answer 4 while
+waiting and 1 once reached, 0 after reset and 0X0F after stop. set keeps the day count and moves the
+waiting alarm to the next time the new clock reads its hour:minute:second, so setting past it waits for
+the next day, second_count keeps the seconds it had to go, it measures elapsed seconds whatever the
+clock reads. Counting down (decrement) the alarm is reached when the time of day matches, the day
+count is ignored, so from 00:05:00 an alarm at 00:00:00 is reached after 300 decrements even though it
+was stored for the next day. second_count counting down is reached only on its exact second.
+*************/
 /***EOF***/
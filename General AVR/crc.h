@@ -0,0 +1,34 @@
+/************************************************************************
+	CRC
+Author: Sergio Santos
+	<sergio.salazar.santos@gmail.com>
+License: GNU General Public License
+Hardware: all
+Date: 17102026
+Comment:
+	Table driven, tables in program memory
+************************************************************************/
+#ifndef _CRC_H_
+	#define _CRC_H_
+/***Library***/
+#include <inttypes.h>
+#include <stddef.h>
+/***Constant & Macro***/
+#define CRC8_INIT 0x00
+#define CRC16_INIT 0xFFFF
+/***Global Variable***/
+struct crc{
+	/***PROTOTYPES VTABLE***/
+	uint8_t (*crc8)(uint8_t crc, const void* data, size_t n);
+	uint16_t (*crc16)(uint16_t crc, const void* data, size_t n);
+};
+typedef struct crc CRC;
+/***Header***/
+CRC CRCenable(void);
+#endif
+/***Comment***
+crc8 is Dallas/Maxim polynomial x^8+x^5+x^4+1 (0x31), reflected, init 0x00.
+crc16 is CCITT polynomial x^16+x^12+x^5+1 (0x1021), not reflected, init 0xFFFF.
+Pass the previous result as crc to continue over several buffers.
+*************/
+/***EOF***/
@@ -13,6 +13,8 @@ Comment:
 /***Constant & Macro***/
 /***Global File Variable***/
 /***Header***/
+void EEPROM_flush(void);
+uint8_t EEPROM_pending(void);
 /***Procedure & Function***/
 EEPROM EEPROMenable(void){
 	EEPROM eprom;
@@ -22,17 +24,27 @@ EEPROM EEPROMenable(void){
 	eprom.read_word=eeprom_read_word;
 	eprom.write_word=eeprom_write_word;
 	eprom.update_word=eeprom_update_word;
-	//eeprom.read_dword=eeprom_read_dword;
+	eprom.read_dword=eeprom_read_dword;
 	eprom.write_dword=eeprom_write_dword;
-	eprom.write_dword=eeprom_write_dword;
-	//eeprom.read_float=eeprom_read_float;
+	eprom.update_dword=eeprom_update_dword;
+	eprom.read_float=eeprom_read_float;
 	eprom.write_float=eeprom_write_float;
 	eprom.update_float=eeprom_update_float;
 	eprom.read_block=eeprom_read_block;
 	eprom.write_block=eeprom_write_block;
 	eprom.update_block=eeprom_update_block;
+	eprom.flush=EEPROM_flush;
+	eprom.pending=EEPROM_pending;
 	return eprom;
 }
+void EEPROM_flush(void)
+{
+	eeprom_busy_wait();
+}
+uint8_t EEPROM_pending(void)
+{
+	return !eeprom_is_ready();
+}
 /***Interrupt***/
 /***Comment***
 *************/
@@ -26,15 +26,17 @@ struct prm{
 	uint16_t (*read_word) ( const uint16_t * addr );
 	void (*write_word) ( uint16_t *addr , uint16_t value );
 	void (*update_word) ( uint16_t *addr , uint16_t value );
-	uint16_t (*read_dword) ( const uint32_t * addr );
+	uint32_t (*read_dword) ( const uint32_t * addr );
 	void (*write_dword) ( uint32_t *addr , uint32_t value );
 	void (*update_dword) ( uint32_t *addr , uint32_t value );
-	uint16_t (*read_float) ( const float * addr );
+	float (*read_float) ( const float * addr );
 	void (*write_float) ( float *addr , float value );
 	void (*update_float) ( float *addr , float value );
 	void (*read_block) ( void * pointer_ram , const void * pointer_eeprom , size_t n);
 	void (*write_block) ( const void * pointer_ram , void * pointer_eeprom , size_t n);
 	void (*update_block) ( const void * pointer_ram , void * pointer_eeprom , size_t n);
+	void (*flush) ( void );
+	uint8_t (*pending) ( void );
 };
 typedef struct prm EEPROM;
 /***Header***/
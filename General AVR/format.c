@@ -0,0 +1,263 @@
+/*************************************************************************
+	FORMAT
+Author: Sergio Santos
+	<sergio.salazar.santos@gmail.com>
+License: GNU General Public License
+Hardware: all
+Date: 17102026
+Comment:
+	printf like writer with PROGMEM format, straight to a character sink
+************************************************************************/
+/***Library***/
+#include <inttypes.h>
+#include <stdarg.h>
+#include <avr/pgmspace.h>
+#include "format.h"
+#include "lcd.h"
+#include "lcdfb.h"
+/***Constant & Macro***/
+#define ZERO 0
+#define ONE 1
+//flags
+#define FORMAT_LEFT 0x01
+#define FORMAT_ZERO 0x02
+#define FORMAT_PLUS 0x04
+#define FORMAT_LONG 0x08
+#define FORMAT_UPPER 0x10
+#define FORMAT_NEG 0x20
+#define FORMAT_HEX 0x40
+#define FORMAT_DIGITS 10
+/***Global File Variable***/
+const uint32_t FORMAT_POW10[FORMAT_DIGITS] PROGMEM={
+	1000000000UL, 100000000UL, 10000000UL, 1000000UL, 100000UL,
+	10000UL, 1000UL, 100UL, 10UL, 1UL
+};
+/***Header***/
+uint16_t FORMAT_print(FORMAT* self, const char* fmt, ...);
+uint16_t FORMAT_vprint(FORMAT* self, const char* fmt, va_list ap);
+uint16_t FORMAT_number(FORMAT* self, uint32_t v, uint8_t flags, uint8_t width, uint8_t precision);
+uint16_t FORMAT_string(FORMAT* self, const char* s, uint8_t pgm, uint8_t flags, uint8_t width, uint8_t precision);
+uint16_t FORMAT_pad(FORMAT* self, char c, uint8_t n);
+/***Procedure & Function***/
+FORMAT FORMATenable(void (*sink)(void* ctx, char c), void* ctx)
+{
+	//ALLOCAÇÂO MEMORIA PARA Estrutura
+	FORMAT format;
+	//import parametros
+	format.sink=sink;
+	format.ctx=ctx;
+	//Direccionar apontadores para PROTOTIPOS
+	format.print=FORMAT_print;
+	format.vprint=FORMAT_vprint;
+	//
+	return format;
+}
+uint16_t FORMAT_print(FORMAT* self, const char* fmt, ...)
+{
+	uint16_t count;
+	va_list ap;
+	va_start(ap, fmt);
+	count=FORMAT_vprint(self, fmt, ap);
+	va_end(ap);
+	return count;
+}
+uint16_t FORMAT_vprint(FORMAT* self, const char* fmt, va_list ap)
+{
+	uint16_t count=ZERO;
+	uint8_t flags, width, precision;
+	int32_t value;
+	char c;
+	while((c=pgm_read_byte(fmt++))){
+		if(c != '%'){
+			self->sink(self->ctx, c);
+			count++;
+			continue;
+		}
+		/***flags***/
+		flags=ZERO;
+		for(;;){
+			c=pgm_read_byte(fmt++);
+			if(c == '-') flags|=FORMAT_LEFT;
+			else if(c == '0') flags|=FORMAT_ZERO;
+			else if(c == '+') flags|=FORMAT_PLUS;
+			else break;
+		}
+		/***width***/
+		width=ZERO;
+		while(c >= '0' && c <= '9'){
+			width=width*10+(c-'0');
+			c=pgm_read_byte(fmt++);
+		}
+		/***precision***/
+		precision=ZERO;
+		if(c == '.'){
+			c=pgm_read_byte(fmt++);
+			while(c >= '0' && c <= '9'){
+				precision=precision*10+(c-'0');
+				c=pgm_read_byte(fmt++);
+			}
+		}
+		if(c == 'l'){
+			flags|=FORMAT_LONG;
+			c=pgm_read_byte(fmt++);
+		}
+		switch(c){
+			case 'd':
+			case 'i':
+				if(flags & FORMAT_LONG)
+					value=va_arg(ap, int32_t);
+				else
+					value=va_arg(ap, int);
+				if(value < ZERO){
+					flags|=FORMAT_NEG;
+					count+=FORMAT_number(self, -(uint32_t)value, flags, width, precision);
+				}else
+					count+=FORMAT_number(self, value, flags, width, precision);
+				break;
+			case 'u':
+				if(flags & FORMAT_LONG)
+					count+=FORMAT_number(self, va_arg(ap, uint32_t), flags, width, precision);
+				else
+					count+=FORMAT_number(self, va_arg(ap, unsigned int), flags, width, precision);
+				break;
+			case 'X':
+				flags|=FORMAT_UPPER;
+				// fall through
+			case 'x':
+				flags|=FORMAT_HEX;
+				flags&=~FORMAT_PLUS;
+				if(flags & FORMAT_LONG)
+					count+=FORMAT_number(self, va_arg(ap, uint32_t), flags, width, precision);
+				else
+					count+=FORMAT_number(self, va_arg(ap, unsigned int), flags, width, precision);
+				break;
+			case 'c':
+				count+=FORMAT_pad(self, ' ', (flags & FORMAT_LEFT) || !width ? ZERO : width-ONE);
+				self->sink(self->ctx, (char)va_arg(ap, int));
+				count++;
+				count+=FORMAT_pad(self, ' ', (flags & FORMAT_LEFT) && width ? width-ONE : ZERO);
+				break;
+			case 's':
+				count+=FORMAT_string(self, va_arg(ap, const char*), ZERO, flags, width, precision);
+				break;
+			case 'S':
+				count+=FORMAT_string(self, va_arg(ap, const char*), ONE, flags, width, precision);
+				break;
+			case '%':
+				self->sink(self->ctx, '%');
+				count++;
+				break;
+			case '\0':
+				return count; // format ends inside conversion
+			default:
+				break;
+		}
+	}
+	return count;
+}
+uint16_t FORMAT_number(FORMAT* self, uint32_t v, uint8_t flags, uint8_t width, uint8_t precision)
+// decimal with fixed point or hexadecimal, padded to width
+{
+	uint8_t ndigit, len, i, d;
+	uint32_t p;
+	uint16_t count=ZERO;
+	char sign=ZERO;
+	/***digits***/
+	if(flags & FORMAT_HEX){
+		precision=ZERO;
+		for(ndigit=ONE;ndigit<8 && (v>>(ndigit<<2));ndigit++);
+	}else{
+		if(precision > FORMAT_DIGITS-ONE)
+			precision=FORMAT_DIGITS-ONE;
+		for(i=ZERO;i<FORMAT_DIGITS-ONE && v < pgm_read_dword(&FORMAT_POW10[i]);i++);
+		ndigit=FORMAT_DIGITS-i;
+		if(ndigit <= precision)
+			ndigit=precision+ONE; // 0.05
+	}
+	if(flags & FORMAT_NEG)
+		sign='-';
+	else if(flags & FORMAT_PLUS)
+		sign='+';
+	len=ndigit+(precision ? ONE : ZERO)+(sign ? ONE : ZERO);
+	len=(width > len) ? width-len : ZERO; // padding
+	/***left padding and sign***/
+	if(!(flags & (FORMAT_LEFT | FORMAT_ZERO)))
+		count+=FORMAT_pad(self, ' ', len);
+	if(sign){
+		self->sink(self->ctx, sign);
+		count++;
+	}
+	if(!(flags & FORMAT_LEFT) && (flags & FORMAT_ZERO))
+		count+=FORMAT_pad(self, '0', len);
+	/***digits***/
+	if(flags & FORMAT_HEX){
+		for(i=ndigit;i;i--){
+			d=(v>>((i-ONE)<<2)) & 0x0F;
+			if(d < 10)
+				self->sink(self->ctx, '0'+d);
+			else
+				self->sink(self->ctx, ((flags & FORMAT_UPPER) ? 'A' : 'a')+d-10);
+		}
+	}else{
+		for(i=FORMAT_DIGITS-ndigit;i<FORMAT_DIGITS;i++){
+			p=pgm_read_dword(&FORMAT_POW10[i]);
+			for(d='0';v >= p;d++)
+				v-=p;
+			self->sink(self->ctx, d);
+			if(precision && i == FORMAT_DIGITS-ONE-precision){
+				self->sink(self->ctx, '.');
+				count++;
+			}
+		}
+	}
+	count+=ndigit;
+	/***right padding***/
+	if(flags & FORMAT_LEFT)
+		count+=FORMAT_pad(self, ' ', len);
+	return count;
+}
+uint16_t FORMAT_string(FORMAT* self, const char* s, uint8_t pgm, uint8_t flags, uint8_t width, uint8_t precision)
+{
+	uint16_t len=ZERO, pos; // strings longer than 255
+	uint8_t i;
+	char c;
+	/***length***/
+	for(;;){
+		c=pgm ? pgm_read_byte(s+len) : s[len];
+		if(!c || (precision && len == precision))
+			break;
+		len++;
+	}
+	i=(width > len) ? width-len : ZERO;
+	if(!(flags & FORMAT_LEFT))
+		FORMAT_pad(self, ' ', i);
+	for(pos=ZERO;pos<len;pos++)
+		self->sink(self->ctx, pgm ? pgm_read_byte(s+pos) : s[pos]);
+	if(flags & FORMAT_LEFT)
+		FORMAT_pad(self, ' ', i);
+	return len+i;
+}
+uint16_t FORMAT_pad(FORMAT* self, char c, uint8_t n)
+{
+	uint8_t i;
+	for(i=ZERO;i<n;i++)
+		self->sink(self->ctx, c);
+	return n;
+}
+void FORMAT_putc(void* ctx, char c)
+// ctx is the address of a putc member, &uart.putc
+{
+	(*(void (**)(unsigned char))ctx)((unsigned char)c);
+}
+void FORMAT_lcd(void* ctx, char c)
+// ctx is the LCD vtable
+{
+	((struct dspl*)ctx)->putch(c);
+}
+void FORMAT_lcdfb(void* ctx, char c)
+// ctx is the LCDFB
+{
+	((LCDFB*)ctx)->putch((LCDFB*)ctx, c);
+}
+/***Interrupt***/
+/***EOF***/
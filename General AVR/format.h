@@ -0,0 +1,44 @@
+/************************************************************************
+	FORMAT
+Author: Sergio Santos
+	<sergio.salazar.santos@gmail.com>
+License: GNU General Public License
+Hardware: all
+Date: 17102026
+Comment:
+	printf like writer with PROGMEM format, straight to a character sink
+************************************************************************/
+#ifndef _FORMAT_H_
+	#define _FORMAT_H_
+/***Library***/
+#include <inttypes.h>
+#include <stdarg.h>
+#include <avr/pgmspace.h>
+/***Constant & Macro***/
+/***Global Variable***/
+struct format{
+	void (*sink)(void* ctx, char c);
+	void* ctx; // instance behind sink
+	/******/
+	uint16_t (*print)(struct format* self, const char* fmt, ...);
+	uint16_t (*vprint)(struct format* self, const char* fmt, va_list ap);
+};
+typedef struct format FORMAT;
+/***Header***/
+FORMAT FORMATenable(void (*sink)(void* ctx, char c), void* ctx);
+void FORMAT_putc(void* ctx, char c);
+void FORMAT_lcd(void* ctx, char c);
+void FORMAT_lcdfb(void* ctx, char c);
+#endif
+/***Comment***
+fmt is in PROGMEM, use PSTR("..."). Conversion %[flags][width][.precision][l]type, flags '-' left
+align, '0' zero fill, '+' sign always. Types d i u x X c s S %, l for 32 bit, s is a RAM string and S a
+PROGMEM string, precision limits string length. On d i u precision is fixed point decimals, the value
+is in units of 10^-precision, print(&out, PSTR("%7.2d"), -1234) gives " -12.34" and no float is used.
+Characters go one at a time to sink(ctx, c), ctx is the instance behind it. Ready sinks: FORMAT_putc
+with ctx &uart.putc (any vtable putc taking unsigned char), FORMAT_lcd with the LCD vtable and
+FORMAT_lcdfb with an LCDFB, e.g. FORMATenable(FORMAT_lcdfb, &fb). Nothing is buffered or allocated so
+print is reentrant with one FORMAT per sink. Digits come from a
+PROGMEM power of ten table by subtraction, no 32 bit division. Returns characters written.
+*************/
+/***EOF***/
@@ -0,0 +1,213 @@
+/*************************************************************************
+	GLYPH
+Author: Sergio Santos
+	<sergio.salazar.santos@gmail.com>
+License: GNU General Public License
+Hardware: HD44780
+Date: 17102026
+Comment:
+	CGRAM custom character cache, bar graph and big digits
+************************************************************************/
+/***Library***/
+#include <stddef.h>
+#include <inttypes.h>
+#include <avr/pgmspace.h>
+#include "glyph.h"
+/***Constant & Macro***/
+#define ZERO 0
+#define ONE 1
+//CMD RS
+#define INST 0
+//bar
+#define GLYPH_BAR_STEPS 5
+//big digit segments
+#define LT 0
+#define UB 1
+#define RT 2
+#define LL 3
+#define LB 4
+#define LR 5
+#define UMB 6
+#define LMB 7
+#define SP 8 // blank
+#define FB 9 // full block
+/***Global File Variable***/
+const uint8_t GLYPH_BAR[4][8] PROGMEM={
+	{0x10,0x10,0x10,0x10,0x10,0x10,0x10,0x10},
+	{0x18,0x18,0x18,0x18,0x18,0x18,0x18,0x18},
+	{0x1C,0x1C,0x1C,0x1C,0x1C,0x1C,0x1C,0x1C},
+	{0x1E,0x1E,0x1E,0x1E,0x1E,0x1E,0x1E,0x1E}
+};
+const uint8_t GLYPH_SEGMENT[8][8] PROGMEM={
+	{0x07,0x0F,0x1F,0x1F,0x1F,0x1F,0x1F,0x1F}, // LT
+	{0x1F,0x1F,0x1F,0x00,0x00,0x00,0x00,0x00}, // UB
+	{0x1C,0x1E,0x1F,0x1F,0x1F,0x1F,0x1F,0x1F}, // RT
+	{0x1F,0x1F,0x1F,0x1F,0x1F,0x1F,0x0F,0x07}, // LL
+	{0x00,0x00,0x00,0x00,0x00,0x1F,0x1F,0x1F}, // LB
+	{0x1F,0x1F,0x1F,0x1F,0x1F,0x1F,0x1E,0x1C}, // LR
+	{0x1F,0x1F,0x1F,0x00,0x00,0x00,0x1F,0x1F}, // UMB
+	{0x1F,0x00,0x00,0x00,0x00,0x1F,0x1F,0x1F}  // LMB
+};
+// top row then bottom row
+const uint8_t GLYPH_DIGIT[10][6] PROGMEM={
+	{LT,UB,RT,LL,LB,LR}, // 0
+	{UB,RT,SP,LB,FB,LB}, // 1
+	{UMB,UMB,RT,LL,LB,LB}, // 2
+	{UMB,UMB,RT,LMB,LMB,LR}, // 3
+	{LL,LB,FB,SP,SP,FB}, // 4
+	{FB,UMB,UMB,LMB,LMB,LR}, // 5
+	{LT,UMB,UMB,LL,LB,LR}, // 6
+	{UB,UB,RT,SP,SP,FB}, // 7
+	{LT,UMB,RT,LL,LB,LR}, // 8
+	{LT,UMB,RT,SP,SP,FB}  // 9
+};
+/***Header***/
+uint8_t GLYPH_get(GLYPH* self, const uint8_t* pattern);
+void GLYPH_invalidate(GLYPH* self);
+void GLYPH_bar(GLYPH* self, uint8_t y, uint8_t x, uint8_t width, uint16_t value, uint16_t max);
+void GLYPH_digit(GLYPH* self, uint8_t y, uint8_t x, uint8_t d);
+void GLYPH_number(GLYPH* self, uint8_t y, uint8_t x, uint16_t value, uint8_t ndigit);
+void GLYPH_touch(GLYPH* self, uint8_t pos);
+void GLYPH_gotoxy(GLYPH* self, uint8_t y, uint8_t x);
+void GLYPH_putch(GLYPH* self, char c);
+/***Procedure & Function***/
+GLYPH GLYPHenable(struct dspl* lcd, struct lcdfb* fb)
+{
+	//ALLOCAÇÂO MEMORIA PARA Estrutura
+	GLYPH glyph;
+	//import parametros
+	glyph.lcd=lcd;
+	glyph.fb=fb;
+	//inic variables
+	GLYPH_invalidate(&glyph);
+	//Direccionar apontadores para PROTOTIPOS
+	glyph.get=GLYPH_get;
+	glyph.invalidate=GLYPH_invalidate;
+	glyph.bar=GLYPH_bar;
+	glyph.digit=GLYPH_digit;
+	glyph.number=GLYPH_number;
+	//
+	return glyph;
+}
+uint8_t GLYPH_get(GLYPH* self, const uint8_t* pattern)
+{
+	uint8_t pos, slot, i;
+	for(pos=ZERO;pos<GLYPH_SLOTS;pos++){
+		slot=self->lru[pos];
+		if(self->slot[slot] == pattern){
+			self->hit++;
+			GLYPH_touch(self, pos);
+			return slot;
+		}
+	}
+	/***miss, replace least recently used***/
+	pos=GLYPH_SLOTS-ONE;
+	slot=self->lru[pos];
+	self->lcd->write(0x40 | (slot<<3), INST); // CGRAM address
+	self->lcd->BF();
+	for(i=ZERO;i<8;i++)
+		self->lcd->putch(pgm_read_byte(pattern+i));
+	if(self->fb)
+		self->fb->addr=LCDFB_UNKNOWN; // counter is in CGRAM, next flush sets DDRAM address
+	self->slot[slot]=pattern;
+	self->miss++;
+	GLYPH_touch(self, pos);
+	return slot;
+}
+void GLYPH_invalidate(GLYPH* self)
+{
+	uint8_t i;
+	for(i=ZERO;i<GLYPH_SLOTS;i++){
+		self->slot[i]=NULL;
+		self->lru[i]=i;
+	}
+	self->hit=ZERO;
+	self->miss=ZERO;
+}
+void GLYPH_bar(GLYPH* self, uint8_t y, uint8_t x, uint8_t width, uint16_t value, uint16_t max)
+{
+	uint16_t fill;
+	uint8_t i, part, code=GLYPH_BLANK;
+	if(!max)
+		return;
+	if(value > max)
+		value=max;
+	fill=((uint32_t)value*width*GLYPH_BAR_STEPS+(max>>1))/max; // columns lit
+	part=fill%GLYPH_BAR_STEPS;
+	if(part)
+		code=GLYPH_get(self, GLYPH_BAR[part-ONE]);
+	GLYPH_gotoxy(self, y, x);
+	for(i=ZERO;i<width;i++,fill-=GLYPH_BAR_STEPS){
+		if(fill >= GLYPH_BAR_STEPS){
+			GLYPH_putch(self, GLYPH_FULL);
+		}else{
+			GLYPH_putch(self, fill ? code : GLYPH_BLANK);
+			fill=GLYPH_BAR_STEPS; // rest blank
+			code=GLYPH_BLANK;
+		}
+	}
+}
+void GLYPH_digit(GLYPH* self, uint8_t y, uint8_t x, uint8_t d)
+{
+	uint8_t code[6];
+	uint8_t i, seg;
+	if(d > 9)
+		return;
+	for(i=ZERO;i<6;i++){
+		seg=pgm_read_byte(&GLYPH_DIGIT[d][i]);
+		if(seg == SP)
+			code[i]=GLYPH_BLANK;
+		else if(seg == FB)
+			code[i]=GLYPH_FULL;
+		else
+			code[i]=GLYPH_get(self, GLYPH_SEGMENT[seg]);
+	}
+	GLYPH_gotoxy(self, y, x);
+	for(i=ZERO;i<3;i++)
+		GLYPH_putch(self, code[i]);
+	GLYPH_gotoxy(self, y+ONE, x);
+	for(i=3;i<6;i++)
+		GLYPH_putch(self, code[i]);
+}
+void GLYPH_number(GLYPH* self, uint8_t y, uint8_t x, uint16_t value, uint8_t ndigit)
+{
+	uint8_t pos, i;
+	for(pos=ndigit;pos;pos--){
+		if(value || pos == ndigit)
+			GLYPH_digit(self, y, x+(pos-ONE)*4, value%10);
+		else{
+			// leading blank
+			GLYPH_gotoxy(self, y, x+(pos-ONE)*4);
+			for(i=ZERO;i<3;i++)
+				GLYPH_putch(self, GLYPH_BLANK);
+			GLYPH_gotoxy(self, y+ONE, x+(pos-ONE)*4);
+			for(i=ZERO;i<3;i++)
+				GLYPH_putch(self, GLYPH_BLANK);
+		}
+		value/=10;
+	}
+}
+void GLYPH_touch(GLYPH* self, uint8_t pos)
+// move entry to most recent
+{
+	uint8_t slot=self->lru[pos];
+	for(;pos;pos--)
+		self->lru[pos]=self->lru[pos-ONE];
+	self->lru[ZERO]=slot;
+}
+void GLYPH_gotoxy(GLYPH* self, uint8_t y, uint8_t x)
+{
+	if(self->fb)
+		self->fb->gotoxy(self->fb, y, x);
+	else
+		self->lcd->gotoxy(y, x);
+}
+void GLYPH_putch(GLYPH* self, char c)
+{
+	if(self->fb)
+		self->fb->putch(self->fb, c);
+	else
+		self->lcd->putch(c);
+}
+/***Interrupt***/
+/***EOF***/
@@ -0,0 +1,54 @@
+/************************************************************************
+	GLYPH
+Author: Sergio Santos
+	<sergio.salazar.santos@gmail.com>
+License: GNU General Public License
+Hardware: HD44780
+Date: 17102026
+Comment:
+	CGRAM custom character cache, bar graph and big digits
+************************************************************************/
+#ifndef _GLYPH_H_
+	#define _GLYPH_H_
+/***Library***/
+#include <inttypes.h>
+#include <avr/pgmspace.h>
+#include "lcd.h"
+#include "lcdfb.h"
+/***Constant & Macro***/
+#define GLYPH_SLOTS 8
+#define GLYPH_FULL 0xFF // ROM A00 full block
+#define GLYPH_BLANK ' '
+/***Global Variable***/
+struct glyph{
+	struct dspl* lcd;
+	struct lcdfb* fb; // draw target when not NULL, CGRAM still goes through lcd
+	const uint8_t* slot[GLYPH_SLOTS]; // PROGMEM pattern held in each CGRAM slot
+	uint8_t lru[GLYPH_SLOTS]; // slots, most recent first
+	uint16_t hit;
+	uint16_t miss;
+	/******/
+	uint8_t (*get)(struct glyph* self, const uint8_t* pattern);
+	void (*invalidate)(struct glyph* self);
+	void (*bar)(struct glyph* self, uint8_t y, uint8_t x, uint8_t width, uint16_t value, uint16_t max);
+	void (*digit)(struct glyph* self, uint8_t y, uint8_t x, uint8_t d);
+	void (*number)(struct glyph* self, uint8_t y, uint8_t x, uint16_t value, uint8_t ndigit);
+};
+typedef struct glyph GLYPH;
+/***Header***/
+GLYPH GLYPHenable(struct dspl* lcd, struct lcdfb* fb);
+#endif
+/***Comment***
+get returns the character code (0 to 7) of an 8 byte PROGMEM pattern, the pattern address is the key.
+On a miss the least recently used slot is written (one instruction and 8 data writes) and the LCD address
+counter is left in CGRAM, so fetch every glyph of a frame first and gotoxy before printing, the renderers
+do it that way. With an LCDFB (fb not NULL) the renderers draw into its frame and a miss marks its address
+counter unknown, so its next flush sends a DDRAM address before any character. When LCDFB is stepped
+from a timer tick keep glyph draw calls out of a running flush, CGRAM is written through lcd directly.
+A redraw with the same glyphs writes no CGRAM at all, hit and miss count it.
+bar draws a horizontal bar of width cells with 5 steps per cell (4 partial glyphs and the ROM full block).
+digit draws a 3x2 digit from 8 segment glyphs, number prints right aligned digits 4 columns apart.
+Evicting a slot changes every cell on screen that shows it, bar and big digits together need 12 glyphs
+so keep them on different pages. Call invalidate after the LCD reboots, CGRAM is lost on power down.
+*************/
+/***EOF***/
@@ -0,0 +1,115 @@
+/*************************************************************************
+	PLANTBENCH
+Author: Sergio Santos
+	<sergio.salazar.santos@gmail.com>
+License: GNU General Public License
+Hardware: PC
+Date: 17102026
+Comment:
+	ZNPID and QPID closed loop on the PLANTSIM models, quality and time per step
+************************************************************************/
+/***Library***/
+#include <stdio.h>
+#include <time.h>
+#include <inttypes.h>
+#include "znpid.h"
+#include "qpid.h"
+#include "plantsim.h"
+/***Constant & Macro***/
+#define DT 0.01 // seconds, QPID step is 10ms
+#define DEADTIME 0.3
+#define SETPOINT 100
+#define STEPS 1000000
+#define BAND 0.02
+#define LIMIT 1023
+/***Global File Variable***/
+const char* plantbench_name[3]={"fopdt", "integrating", "thermal"};
+const float plantbench_gain[3]={2, 0.5, 0.2};
+const float plantbench_tau[3]={2, 1, 30};
+const float plantbench_kc[3]={0.8, 4, 8};
+const float plantbench_ki[3]={0.4, 0.05, 0.2};
+const float plantbench_kd[3]={0.1, 1, 0.1};
+/***Header***/
+uint32_t plantbench_clock(void);
+float plantbench_znpid(void* ctx, float SP, float PV, float dt);
+float plantbench_qpid(void* ctx, float SP, float PV, float dt);
+float plantbench_null(void* ctx, float SP, float PV, float dt);
+void plantbench_print(const char* name, const char* control, struct plantbench* r);
+/***Procedure & Function***/
+int main(void)
+{
+	PLANTSIM plant;
+	ZNPID znpid;
+	QPID qpid;
+	struct plantbench r;
+	int m, bad=0;
+	/***what is left of the timing overhead, should be near 0 ns/step***/
+	plant=PLANTSIMenable(PLANTSIM_FOPDT, plantbench_gain[0], plantbench_tau[0], DEADTIME, DT);
+	plant.bench(&plant, plantbench_null, NULL, SETPOINT, STEPS, BAND, plantbench_clock, &r);
+	plantbench_print("no control", "null", &r);
+	for(m=0;m<3;m++){
+		plant=PLANTSIMenable(m, plantbench_gain[m], plantbench_tau[m], DEADTIME, DT);
+		if(plant.clipped){
+			printf("%s dead time longer than PLANTSIM_DELAY_MAX\n", plantbench_name[m]);
+			bad++;
+		}
+		znpid=ZNPIDenable();
+		znpid.set_kc(&znpid, plantbench_kc[m]);
+		znpid.set_ki(&znpid, plantbench_ki[m]);
+		znpid.set_kd(&znpid, plantbench_kd[m]);
+		plant.bench(&plant, plantbench_znpid, &znpid, SETPOINT, STEPS, BAND, plantbench_clock, &r);
+		plantbench_print(plantbench_name[m], "ZNPID", &r);
+		qpid=QPIDenable((uint16_t)(DT*1000+0.5));
+		qpid.set_kc(&qpid, (int32_t)(plantbench_kc[m]*QPID_ONE));
+		qpid.set_ki(&qpid, (int32_t)(plantbench_ki[m]*QPID_ONE));
+		qpid.set_kd(&qpid, (int32_t)(plantbench_kd[m]*QPID_ONE));
+		qpid.set_limit(&qpid, -LIMIT, LIMIT);
+		plant.bench(&plant, plantbench_qpid, &qpid, SETPOINT, STEPS, BAND, plantbench_clock, &r);
+		plantbench_print(plantbench_name[m], "QPID", &r);
+	}
+	return bad ? 1 : 0;
+}
+uint32_t plantbench_clock(void)
+// ns, wraps every 4.3s, bench only sums differences
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (uint32_t)(t.tv_sec*1000000000ULL+t.tv_nsec);
+}
+float plantbench_znpid(void* ctx, float SP, float PV, float dt)
+{
+	ZNPID* znpid=ctx;
+	float u;
+	znpid->SetPoint=SP;
+	u=znpid->output(znpid, PV, dt);
+	return (u > LIMIT) ? LIMIT : (u < -LIMIT) ? -LIMIT : u;
+}
+float plantbench_qpid(void* ctx, float SP, float PV, float dt)
+// PV rounded to the integer unit like an ADC reading
+{
+	QPID* qpid=ctx;
+	(void)dt; // fixed in QPIDenable
+	qpid->set_SP(qpid, (int16_t)SP);
+	return qpid->output(qpid, (int16_t)(PV < 0 ? PV-0.5f : PV+0.5f));
+}
+float plantbench_null(void* ctx, float SP, float PV, float dt)
+{
+	(void)ctx; (void)SP; (void)PV; (void)dt;
+	return 0;
+}
+void plantbench_print(const char* name, const char* control, struct plantbench* r)
+{
+	printf("%-12s %-6s IAE %8.1f overshoot %5.1f%% settling %7.2fs %" PRIu32 " steps %" PRIu64 " ns %.1f ns/step\n",
+		name, control, r->iae, r->overshoot, r->settling, r->steps, r->cost, r->cost_step);
+}
+/***Comment***
+gcc -std=gnu99 -O2 -I"General AVR" "General AVR/host/plantbench.c" "General AVR/plantsim.c"
+	"General AVR/znpid.c" "General AVR/qpid.c" -o plantbench
+Same gains on both controllers, QPID at the fixed 10ms step with PV in integer units. They do not
+give the same loop: ZNPID takes the derivative on the error and only resets its integral on overflow,
+QPID takes it on PV and clamps the integral, so compare each against its own earlier run after a
+change. ns/step is the PC time per output with the clock reads taken out, the null line shows what is
+left of that overhead, it only ranks the two, the AVR cost is in qpid.h. Exit
+status 1 when a dead time did not fit the delay line.
+*************/
+/***EOF***/
@@ -0,0 +1,84 @@
+/*************************************************************************
+	SDLOGBENCH
+Author: Sergio Santos
+	<sergio.salazar.santos@gmail.com>
+License: GNU General Public License
+Hardware: PC
+Date: 17102026
+Comment:
+	SDCARD and SDLOG against SDMOCK, round trip check and SPI throughput
+************************************************************************/
+/***Library***/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include "sdmock.h"
+#include "sdlog.h"
+/***Constant & Macro***/
+#define RECORD 37
+#define RECORDS 5000
+#define START 100
+#define NBLOCK 1000
+/***Global File Variable***/
+SDLOG sdlogbench_log; // staging block inside, keep off the stack like on the mcu
+SDLOG sdlogbench_check;
+/***Procedure & Function***/
+int main(int argc, char** argv)
+{
+	SDMOCK mock=SDMOCKenable(argc > 1 ? argv[1] : "sdlogbench.img");
+	double spiclock=(argc > 2) ? atof(argv[2]) : 8e6; // F_CPU/2 at 16MHz
+	SDCARD card=SDCARDenable(&mock.spi, mock.chipselect);
+	uint8_t record[RECORD];
+	uint8_t block[SDCARD_BLOCK_SIZE];
+	uint32_t total=0, bytes, pos, k;
+	uint16_t n, j, bad=0;
+	int i;
+	if(card.init(&card) != SDCARD_OK){
+		printf("init failed\n");
+		return 1;
+	}
+	SDLOGinit(&sdlogbench_log, &card, START, NBLOCK);
+	if(sdlogbench_log.format(&sdlogbench_log) != SDLOG_OK){
+		printf("format failed\n");
+		return 1;
+	}
+	/***sustained append***/
+	bytes=mock.bytes();
+	for(i=0;i<RECORDS;i++){
+		memset(record, i & 0xFF, RECORD);
+		total+=sdlogbench_log.append(&sdlogbench_log, record, RECORD);
+	}
+	bytes=mock.bytes()-bytes;
+	printf("append %lu bytes in %lu blocks, %lu SPI bytes, %.3f payload per SPI byte\n",
+		(unsigned long)total, (unsigned long)sdlogbench_log.written, (unsigned long)bytes, (double)total/bytes);
+	printf("throughput at SPI %.0f Hz: %.0f bytes/s, card busy time not included\n", spiclock, spiclock/8*total/bytes);
+	/***read in the middle of an open stream***/
+	n=sdlogbench_log.read(&sdlogbench_log, 0, block);
+	for(i=0;i<100;i++){
+		memset(record, 0x77, RECORD);
+		total+=sdlogbench_log.append(&sdlogbench_log, record, RECORD);
+	}
+	sdlogbench_log.sync(&sdlogbench_log);
+	/***mount and verify***/
+	SDLOGinit(&sdlogbench_check, &card, START, NBLOCK);
+	if(sdlogbench_check.mount(&sdlogbench_check) != SDLOG_OK || sdlogbench_check.size(&sdlogbench_check) != total){
+		printf("mount failed, size %lu expected %lu\n", (unsigned long)sdlogbench_check.size(&sdlogbench_check), (unsigned long)total);
+		return 1;
+	}
+	for(pos=0, k=0;k <= sdlogbench_check.block;k++){
+		n=sdlogbench_check.read(&sdlogbench_check, k, block);
+		for(j=0;j<n;j++, pos++)
+			if(block[SDLOG_HEADER_SIZE+j] != ((pos/RECORD < RECORDS) ? (pos/RECORD) & 0xFF : 0x77))
+				bad++;
+	}
+	printf("verified %lu bytes, %u bad, %u commands inside CMD25\n", (unsigned long)pos, bad, mock.errors());
+	mock.close();
+	return (bad || mock.errors() || pos != total) ? 1 : 0;
+}
+/***Comment***
+gcc -std=gnu99 -O2 -I"General AVR" -I"General AVR/host" -Iatmega128lib "General AVR/host/sdlogbench.c"
+	"General AVR/host/sdmock.c" "General AVR/sdcard.c" "General AVR/sdlog.c" -o sdlogbench
+./sdlogbench [image] [SPI clock Hz], exit status 0 when the log reads back intact.
+*************/
+/***EOF***/
@@ -0,0 +1,270 @@
+/*************************************************************************
+	SDMOCK
+Author: Sergio Santos
+	<sergio.salazar.santos@gmail.com>
+License: GNU General Public License
+Hardware: PC, SD card in SPI mode over a disk image file
+Date: 17102026
+Comment:
+	SPI vtable answering as an SDHC card, for host runs of SDCARD and SDLOG
+************************************************************************/
+/***Library***/
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include "sdmock.h"
+/***Constant & Macro***/
+#define ZERO 0
+#define ONE 1
+#define SDMOCK_BLOCK 512
+#define SDMOCK_OUT_SIZE 1024 // reply bytes waiting to be clocked out
+/***state***/
+#define SDMOCK_COMMAND 0
+#define SDMOCK_WRITE_TOKEN 1 // CMD24 sent, waiting 0xFE
+#define SDMOCK_WRITE_DATA 2
+#define SDMOCK_MULTI_TOKEN 3 // CMD25 open, waiting 0xFC or 0xFD
+#define SDMOCK_MULTI_DATA 4
+#define SDMOCK_READ_MULTI 5 // CMD18 open until CMD12
+/***Global File Variable***/
+FILE* sdmock_image;
+uint8_t sdmock_out[SDMOCK_OUT_SIZE];
+uint16_t sdmock_head;
+uint16_t sdmock_tail;
+uint8_t sdmock_state;
+uint8_t sdmock_cmd[6];
+uint8_t sdmock_index;
+uint8_t sdmock_app;
+uint32_t sdmock_lba;
+uint8_t sdmock_block[SDMOCK_BLOCK+2]; // data and CRC
+uint16_t sdmock_fill;
+uint32_t sdmock_bytes;
+uint16_t sdmock_errors;
+/***Header***/
+void SDMOCK_transfer_sync(uint8_t* dataout, uint8_t* datain, uint8_t len);
+void SDMOCK_transmit_sync(uint8_t* dataout, uint8_t len);
+uint8_t SDMOCK_fast_shift(uint8_t data);
+void SDMOCK_chipselect(uint8_t select);
+uint32_t SDMOCK_get_bytes(void);
+uint16_t SDMOCK_get_errors(void);
+void SDMOCK_close(void);
+uint8_t SDMOCK_shift(uint8_t in);
+void SDMOCK_push(uint8_t c);
+void SDMOCK_read(uint32_t lba);
+void SDMOCK_write(uint32_t lba);
+void SDMOCK_command(void);
+/***Procedure & Function***/
+SDMOCK SDMOCKenable(const char* image)
+{
+	//ALLOCAÇÂO MEMORIA PARA Estrutura
+	SDMOCK sdmock;
+	//import parametros
+	sdmock_image=fopen(image, "w+b");
+	//inic variables
+	sdmock_head=sdmock_tail=ZERO;
+	sdmock_state=SDMOCK_COMMAND;
+	sdmock_index=ZERO;
+	sdmock_app=ZERO;
+	sdmock_bytes=ZERO;
+	sdmock_errors=ZERO;
+	memset(&sdmock.spi, ZERO, sizeof(SPI));
+	//Direccionar apontadores para PROTOTIPOS
+	sdmock.spi.transfer_sync=SDMOCK_transfer_sync;
+	sdmock.spi.transmit_sync=SDMOCK_transmit_sync;
+	sdmock.spi.fast_shift=SDMOCK_fast_shift;
+	sdmock.chipselect=SDMOCK_chipselect;
+	sdmock.bytes=SDMOCK_get_bytes;
+	sdmock.errors=SDMOCK_get_errors;
+	sdmock.close=SDMOCK_close;
+	//
+	return sdmock;
+}
+void SDMOCK_transfer_sync(uint8_t* dataout, uint8_t* datain, uint8_t len)
+{
+	uint8_t i;
+	for(i=ZERO;i<len;i++)
+		datain[i]=SDMOCK_shift(dataout[i]);
+}
+void SDMOCK_transmit_sync(uint8_t* dataout, uint8_t len)
+{
+	uint8_t i;
+	for(i=ZERO;i<len;i++)
+		SDMOCK_shift(dataout[i]);
+}
+uint8_t SDMOCK_fast_shift(uint8_t data)
+{
+	return SDMOCK_shift(data);
+}
+void SDMOCK_chipselect(uint8_t select)
+{
+	(void)select;
+}
+uint32_t SDMOCK_get_bytes(void)
+{
+	return sdmock_bytes;
+}
+uint16_t SDMOCK_get_errors(void)
+{
+	return sdmock_errors;
+}
+void SDMOCK_close(void)
+{
+	if(sdmock_image)
+		fclose(sdmock_image);
+	sdmock_image=NULL;
+}
+uint8_t SDMOCK_shift(uint8_t in)
+// one SPI byte, card reply out while host byte comes in
+{
+	uint8_t reply=0xFF;
+	sdmock_bytes++;
+	if(sdmock_tail != sdmock_head){
+		reply=sdmock_out[sdmock_tail];
+		sdmock_tail=(sdmock_tail+ONE) % SDMOCK_OUT_SIZE;
+	}
+	switch(sdmock_state){
+		case SDMOCK_WRITE_TOKEN:
+			if(in == 0xFE){
+				sdmock_state=SDMOCK_WRITE_DATA;
+				sdmock_fill=ZERO;
+			}
+			return reply;
+		case SDMOCK_MULTI_TOKEN:
+			if(in == 0xFC){
+				sdmock_state=SDMOCK_MULTI_DATA;
+				sdmock_fill=ZERO;
+			}else if(in == 0xFD){
+				sdmock_state=SDMOCK_COMMAND;
+				SDMOCK_push(0xFF);
+				SDMOCK_push(0x00); // busy
+			}else if((in & 0xC0) == 0x40){
+				sdmock_errors++; // command inside CMD25
+			}
+			return reply;
+		case SDMOCK_WRITE_DATA:
+		case SDMOCK_MULTI_DATA:
+			sdmock_block[sdmock_fill++]=in;
+			if(sdmock_fill == SDMOCK_BLOCK+2){
+				SDMOCK_write(sdmock_lba++);
+				SDMOCK_push(0xE5); // data accepted
+				SDMOCK_push(0x00); // busy
+				sdmock_state=(sdmock_state == SDMOCK_WRITE_DATA) ? SDMOCK_COMMAND : SDMOCK_MULTI_TOKEN;
+			}
+			return reply;
+		case SDMOCK_READ_MULTI:
+			if(sdmock_tail == sdmock_head)
+				SDMOCK_read(sdmock_lba++);
+			break;
+		default:
+			break;
+	}
+	/***command frame***/
+	if(!sdmock_index && (in & 0xC0) != 0x40)
+		return reply;
+	sdmock_cmd[sdmock_index++]=in;
+	if(sdmock_index == 6){
+		sdmock_index=ZERO;
+		SDMOCK_command();
+	}
+	return reply;
+}
+void SDMOCK_push(uint8_t c)
+{
+	sdmock_out[sdmock_head]=c;
+	sdmock_head=(sdmock_head+ONE) % SDMOCK_OUT_SIZE;
+}
+void SDMOCK_read(uint32_t lba)
+// start token, block and CRC
+{
+	uint8_t block[SDMOCK_BLOCK];
+	uint16_t i;
+	memset(block, ZERO, SDMOCK_BLOCK);
+	if(sdmock_image){
+		fseek(sdmock_image, (long)lba*SDMOCK_BLOCK, SEEK_SET);
+		if(fread(block, ONE, SDMOCK_BLOCK, sdmock_image) != SDMOCK_BLOCK)
+			clearerr(sdmock_image);
+	}
+	SDMOCK_push(0xFF);
+	SDMOCK_push(0xFE);
+	for(i=ZERO;i<SDMOCK_BLOCK;i++)
+		SDMOCK_push(block[i]);
+	SDMOCK_push(ZERO);
+	SDMOCK_push(ZERO);
+}
+void SDMOCK_write(uint32_t lba)
+{
+	if(!sdmock_image)
+		return;
+	fseek(sdmock_image, (long)lba*SDMOCK_BLOCK, SEEK_SET);
+	fwrite(sdmock_block, ONE, SDMOCK_BLOCK, sdmock_image);
+}
+void SDMOCK_command(void)
+{
+	uint8_t cmd=sdmock_cmd[0] & 0x3F;
+	uint32_t arg=((uint32_t)sdmock_cmd[1]<<24)|((uint32_t)sdmock_cmd[2]<<16)|((uint16_t)sdmock_cmd[3]<<8)|sdmock_cmd[4];
+	uint8_t app=sdmock_app;
+	sdmock_app=ZERO;
+	if(sdmock_state == SDMOCK_READ_MULTI){
+		if(cmd != 12)
+			return;
+		sdmock_head=sdmock_tail=ZERO; // drop block being sent
+		sdmock_state=SDMOCK_COMMAND;
+		SDMOCK_push(0xFF); // stuff byte
+		SDMOCK_push(ZERO);
+		return;
+	}
+	SDMOCK_push(0xFF); // NCR
+	switch(cmd){
+		case 0:
+			SDMOCK_push(0x01);
+			break;
+		case 8:
+			SDMOCK_push(0x01);
+			SDMOCK_push(ZERO);
+			SDMOCK_push(ZERO);
+			SDMOCK_push(0x01);
+			SDMOCK_push(0xAA);
+			break;
+		case 55:
+			SDMOCK_push(ZERO);
+			sdmock_app=ONE;
+			break;
+		case 41:
+			SDMOCK_push(app ? ZERO : 0x04);
+			break;
+		case 58:
+			SDMOCK_push(ZERO);
+			SDMOCK_push(0xC0); // power up, CCS
+			SDMOCK_push(0xFF);
+			SDMOCK_push(0x80);
+			SDMOCK_push(ZERO);
+			break;
+		case 16:
+		case 23:
+			SDMOCK_push(ZERO);
+			break;
+		case 17:
+			SDMOCK_push(ZERO);
+			SDMOCK_read(arg);
+			break;
+		case 18:
+			SDMOCK_push(ZERO);
+			sdmock_lba=arg;
+			SDMOCK_read(sdmock_lba++);
+			sdmock_state=SDMOCK_READ_MULTI;
+			break;
+		case 24:
+			SDMOCK_push(ZERO);
+			sdmock_lba=arg;
+			sdmock_state=SDMOCK_WRITE_TOKEN;
+			break;
+		case 25:
+			SDMOCK_push(ZERO);
+			sdmock_lba=arg;
+			sdmock_state=SDMOCK_MULTI_TOKEN;
+			break;
+		default:
+			SDMOCK_push(0x04); // illegal
+			break;
+	}
+}
+/***EOF***/
@@ -0,0 +1,38 @@
+/************************************************************************
+	SDMOCK
+Author: Sergio Santos
+	<sergio.salazar.santos@gmail.com>
+License: GNU General Public License
+Hardware: PC, SD card in SPI mode over a disk image file
+Date: 17102026
+Comment:
+	SPI vtable answering as an SDHC card, for host runs of SDCARD and SDLOG
+************************************************************************/
+#ifndef _SDMOCK_H_
+	#define _SDMOCK_H_
+/***Library***/
+#include <inttypes.h>
+#include "atmega128spi.h"
+/***Constant & Macro***/
+/***Global Variable***/
+struct sdmock{
+	SPI spi; // give &spi to SDCARDenable
+	/******/
+	void (*chipselect)(uint8_t select);
+	uint32_t (*bytes)(void); // SPI bytes clocked since enable
+	uint16_t (*errors)(void); // commands seen inside a multiple block write
+	void (*close)(void);
+};
+typedef struct sdmock SDMOCK;
+/***Header***/
+SDMOCK SDMOCKenable(const char* image);
+#endif
+/***Comment***
+One card per program, the SPI vtable has no self. image is created or truncated, blocks never written
+read back as zero. Answers CMD0, CMD8, CMD55/ACMD41, CMD58 (SDHC, block addressing), CMD16, ACMD23,
+CMD17, CMD18/CMD12, CMD24 and CMD25 with the start and stop tokens, every other command is illegal.
+A command byte clocked while a CMD25 is open is counted in errors, a real card would take it as data.
+bytes counts every byte through transfer_sync, transmit_sync and fast_shift, at SPI clock F_CPU/2 one
+byte is 8 clocks. Build on the PC only, see sdlogbench.c.
+*************/
+/***EOF***/
@@ -0,0 +1,148 @@
+/*************************************************************************
+	HX711ACQ
+Author: Sergio Santos
+	<sergio.salazar.santos@gmail.com>
+License: GNU General Public License
+Hardware: HX711
+Date: 17102026
+Comment:
+	HX711 acquisition engine, data ready interrupt and sample ring
+************************************************************************/
+/***Library***/
+#include <avr/io.h>
+#include <inttypes.h>
+#include "hx711acq.h"
+/***Constant & Macro***/
+#ifndef GLOBAL_INTERRUPT_ENABLE
+	#define GLOBAL_INTERRUPT_ENABLE 7
+#endif
+#define ZERO 0
+#define ONE 1
+#define HX711ACQ_BITS 24
+/***Global File Variable***/
+/***Header***/
+void HX711ACQ_ready(HX711ACQ* self);
+uint8_t HX711ACQ_available(HX711ACQ* self);
+uint8_t HX711ACQ_read(HX711ACQ* self, struct hx711sample* sample);
+void HX711ACQ_set_amplify(HX711ACQ* self, uint8_t amplify);
+void HX711ACQ_power(HX711ACQ* self, uint8_t on);
+/***Procedure & Function***/
+HX711ACQ HX711ACQenable(volatile uint8_t *ddr, volatile uint8_t *pin, volatile uint8_t *port, uint8_t datapin, uint8_t clkpin, void (*irq)(uint8_t on))
+{
+	//LOCAL VARIABLES
+	uint8_t tSREG;
+	tSREG=SREG;
+	SREG&=~(1<<GLOBAL_INTERRUPT_ENABLE);
+	//ALLOCAÇÂO MEMORIA PARA Estrutura
+	HX711ACQ hx711;
+	//import parametros
+	hx711.ddr=ddr;
+	hx711.pin=pin;
+	hx711.port=port;
+	hx711.datamask=(ONE<<datapin);
+	hx711.clkmask=(ONE<<clkpin);
+	hx711.irq=irq;
+	//inic variables
+	*hx711.ddr|=hx711.clkmask;
+	*hx711.ddr&=~hx711.datamask;
+	*hx711.port&=~hx711.clkmask; // SCK low keeps the chip on
+	*hx711.port|=hx711.datamask;
+	hx711.pulses=ONE; // channel A gain 128
+	hx711.head=ZERO;
+	hx711.tail=ZERO;
+	hx711.seq=ZERO;
+	hx711.overrun=ZERO;
+	//Direccionar apontadores para PROTOTIPOS
+	hx711.ready=HX711ACQ_ready;
+	hx711.available=HX711ACQ_available;
+	hx711.read=HX711ACQ_read;
+	hx711.set_amplify=HX711ACQ_set_amplify;
+	hx711.power=HX711ACQ_power;
+	if(hx711.irq)
+		hx711.irq(ONE);
+	SREG=tSREG;
+	//
+	return hx711;
+}
+void HX711ACQ_ready(HX711ACQ* self)
+// Function to be used in the interrupt routine
+{
+	volatile uint8_t* port=self->port;
+	volatile uint8_t* pin=self->pin;
+	uint8_t clk=self->clkmask;
+	uint8_t data=self->datamask;
+	uint32_t value=ZERO;
+	uint8_t i, next;
+	if(*pin & data)
+		return; // conversion not ready
+	if(self->irq)
+		self->irq(ZERO);
+	/***24 bits MSB first, data valid 0.1us after rising edge***/
+	for(i=HX711ACQ_BITS;i;i--){
+		*port|=clk;
+		value<<=ONE;
+		if(*pin & data)
+			value|=ONE;
+		*port&=~clk;
+	}
+	/***gain and channel for next conversion***/
+	for(i=self->pulses;i;i--){
+		*port|=clk;
+		(void)*pin; // keep SCK high 0.2us
+		*port&=~clk;
+	}
+	if(value & 0x00800000UL)
+		value|=0xFF000000UL; // two's complement 24 to 32 bit
+	self->seq++;
+	next=(self->head+ONE) & HX711ACQ_RING_MASK;
+	if(next == self->tail){
+		self->overrun++;
+	}else{
+		self->ring[self->head].value=(int32_t)value;
+		self->ring[self->head].seq=self->seq;
+		self->head=next;
+	}
+	if(self->irq)
+		self->irq(ONE);
+}
+uint8_t HX711ACQ_available(HX711ACQ* self)
+{
+	return (self->head-self->tail) & HX711ACQ_RING_MASK;
+}
+uint8_t HX711ACQ_read(HX711ACQ* self, struct hx711sample* sample)
+{
+	if(self->head == self->tail)
+		return ZERO;
+	*sample=self->ring[self->tail];
+	self->tail=(self->tail+ONE) & HX711ACQ_RING_MASK;
+	return ONE;
+}
+void HX711ACQ_set_amplify(HX711ACQ* self, uint8_t amplify)
+{
+	switch(amplify){
+		case 32:
+			self->pulses=2; //channel B
+			break;
+		case 64:
+			self->pulses=3; //channel A
+			break;
+		default:
+			self->pulses=ONE; //channel A 128
+			break;
+	}
+}
+void HX711ACQ_power(HX711ACQ* self, uint8_t on)
+// SCK high for more than 60us powers the chip down
+{
+	if(on){
+		*self->port&=~self->clkmask;
+		if(self->irq)
+			self->irq(ONE);
+	}else{
+		if(self->irq)
+			self->irq(ZERO);
+		*self->port|=self->clkmask;
+	}
+}
+/***Interrupt***/
+/***EOF***/
@@ -0,0 +1,63 @@
+/************************************************************************
+	HX711ACQ
+Author: Sergio Santos
+	<sergio.salazar.santos@gmail.com>
+License: GNU General Public License
+Hardware: HX711
+Date: 17102026
+Comment:
+	HX711 acquisition engine, data ready interrupt and sample ring
+************************************************************************/
+#ifndef _HX711ACQ_H_
+	#define _HX711ACQ_H_
+/***Library***/
+#include <inttypes.h>
+/***Constant & Macro***/
+#ifndef HX711ACQ_RING_SIZE
+	#define HX711ACQ_RING_SIZE 4
+#endif
+#define HX711ACQ_RING_MASK (HX711ACQ_RING_SIZE - 1)
+#if (HX711ACQ_RING_SIZE & HX711ACQ_RING_MASK)
+	#error HX711ACQ ring size is not a power of 2
+#endif
+/***Global Variable***/
+struct hx711sample{
+	int32_t value; // sign extended 24 bit
+	uint8_t seq; // increments every conversion, gaps show lost samples
+};
+struct hx711acq{
+	volatile uint8_t* ddr;
+	volatile uint8_t* pin;
+	volatile uint8_t* port;
+	uint8_t datamask;
+	uint8_t clkmask;
+	uint8_t pulses; // 25 to 27 clocks select next gain
+	void (*irq)(uint8_t on);
+	struct hx711sample ring[HX711ACQ_RING_SIZE];
+	volatile uint8_t head;
+	volatile uint8_t tail;
+	uint8_t seq;
+	uint8_t overrun;
+	/******/
+	void (*ready)(struct hx711acq* self);
+	uint8_t (*available)(struct hx711acq* self);
+	uint8_t (*read)(struct hx711acq* self, struct hx711sample* sample);
+	void (*set_amplify)(struct hx711acq* self, uint8_t amplify);
+	void (*power)(struct hx711acq* self, uint8_t on);
+};
+typedef struct hx711acq HX711ACQ;
+/***Header***/
+HX711ACQ HX711ACQenable(volatile uint8_t *ddr, volatile uint8_t *pin, volatile uint8_t *port, uint8_t datapin, uint8_t clkpin, void (*irq)(uint8_t on));
+#endif
+/***Comment***
+DOUT falls when a conversion is ready. Wire it to an external interrupt on the falling edge (INTn on the
+ATmega128, pin change on the ATmega328) and call ready from that interrupt routine, or call ready from a
+timer interrupt faster than the output rate (10 or 80Hz) when no interrupt pin is free, it returns at once
+while DOUT is high. ready turns the interrupt off with irq(0), clocks 24 bits and the gain pulses in one
+loop, under 1.5us per bit and about 40us in all at 16MHz, interrupts are off inside the routine so no
+other interrupt can stretch a SCK high past the 60us power down limit, sign extends and stores the sample with its sequence number, then irq(1) must clear
+the pending flag set by DOUT toggling and enable the interrupt again. The main loop takes finished
+samples with available/read, when the ring is full new samples are dropped and overrun counts them.
+set_amplify takes 128, 64 (channel A) or 32 (channel B), effective from the conversion after the next.
+*************/
+/***EOF***/
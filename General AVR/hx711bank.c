@@ -0,0 +1,167 @@
+/*************************************************************************
+	HX711BANK
+Author: Sergio Santos
+	<sergio.salazar.santos@gmail.com>
+License: GNU General Public License
+Hardware: HX711 x N
+Date: 17102026
+Comment:
+	N HX711 on one data port with shared SCK, read in one clock pass
+************************************************************************/
+/***Library***/
+#include <avr/io.h>
+#include <inttypes.h>
+#include "hx711bank.h"
+/***Constant & Macro***/
+#ifndef GLOBAL_INTERRUPT_ENABLE
+	#define GLOBAL_INTERRUPT_ENABLE 7
+#endif
+#define ZERO 0
+#define ONE 1
+/***Global File Variable***/
+/***Header***/
+void HX711BANK_ready(HX711BANK* self);
+uint8_t HX711BANK_available(HX711BANK* self);
+uint8_t HX711BANK_read(HX711BANK* self, struct hx711banksample* sample);
+void HX711BANK_set_amplify(HX711BANK* self, uint8_t amplify);
+void HX711BANK_power(HX711BANK* self, uint8_t on);
+/***Procedure & Function***/
+HX711BANK HX711BANKenable(volatile uint8_t *ddr, volatile uint8_t *pin, volatile uint8_t *port, uint8_t datamask, volatile uint8_t *clkddr, volatile uint8_t *clkport, uint8_t clkpin, void (*irq)(uint8_t on))
+{
+	//LOCAL VARIABLES
+	uint8_t tSREG;
+	uint8_t b;
+	tSREG=SREG;
+	SREG&=~(1<<GLOBAL_INTERRUPT_ENABLE);
+	//ALLOCAÇÂO MEMORIA PARA Estrutura
+	HX711BANK hx711;
+	//import parametros
+	hx711.ddr=ddr;
+	hx711.pin=pin;
+	hx711.port=port;
+	hx711.clkddr=clkddr;
+	hx711.clkport=clkport;
+	hx711.clkmask=(ONE<<clkpin);
+	hx711.irq=irq;
+	//inic variables
+	hx711.channels=ZERO;
+	hx711.datamask=ZERO;
+	for(b=ONE;b && hx711.channels < HX711BANK_CHANNELS;b<<=ONE)
+		if(datamask & b){
+			hx711.bit[hx711.channels++]=b;
+			hx711.datamask|=b;
+		}
+	*hx711.clkddr|=hx711.clkmask;
+	*hx711.ddr&=~hx711.datamask;
+	*hx711.clkport&=~hx711.clkmask; // SCK low keeps the chips on
+	*hx711.port|=hx711.datamask;
+	hx711.pulses=ONE; // channel A gain 128
+	hx711.head=ZERO;
+	hx711.tail=ZERO;
+	hx711.seq=ZERO;
+	hx711.overrun=ZERO;
+	//Direccionar apontadores para PROTOTIPOS
+	hx711.ready=HX711BANK_ready;
+	hx711.available=HX711BANK_available;
+	hx711.read=HX711BANK_read;
+	hx711.set_amplify=HX711BANK_set_amplify;
+	hx711.power=HX711BANK_power;
+	if(hx711.irq)
+		hx711.irq(ONE);
+	SREG=tSREG;
+	//
+	return hx711;
+}
+void HX711BANK_ready(HX711BANK* self)
+// Function to be used in the interrupt routine
+{
+	volatile uint8_t* port=self->clkport;
+	volatile uint8_t* pin=self->pin;
+	uint8_t clk=self->clkmask;
+	uint8_t* snap=self->snap;
+	struct hx711banksample* sample;
+	uint32_t value;
+	uint8_t i, c, b, next;
+	if(*pin & self->datamask)
+		return; // some conversion not ready
+	if(self->irq)
+		self->irq(ZERO);
+	/***24 clocks, whole port sampled 0.1us after rising edge***/
+	for(i=ZERO;i<HX711BANK_BITS;i++){
+		*port|=clk;
+		(void)*pin;
+		snap[i]=*pin;
+		*port&=~clk;
+	}
+	/***gain and channel for next conversion***/
+	for(i=self->pulses;i;i--){
+		*port|=clk;
+		(void)*pin; // keep SCK high 0.2us
+		*port&=~clk;
+	}
+	self->seq++;
+	next=(self->head+ONE) & HX711BANK_RING_MASK;
+	if(next == self->tail){
+		self->overrun++;
+	}else{
+		/***port images to channel values, MSB first***/
+		sample=&self->ring[self->head];
+		for(c=ZERO;c<self->channels;c++){
+			b=self->bit[c];
+			value=ZERO;
+			for(i=ZERO;i<HX711BANK_BITS;i++){
+				value<<=ONE;
+				if(snap[i] & b)
+					value|=ONE;
+			}
+			if(value & 0x00800000UL)
+				value|=0xFF000000UL; // two's complement 24 to 32 bit
+			sample->value[c]=(int32_t)value;
+		}
+		sample->seq=self->seq;
+		self->head=next;
+	}
+	if(self->irq)
+		self->irq(ONE);
+}
+uint8_t HX711BANK_available(HX711BANK* self)
+{
+	return (self->head-self->tail) & HX711BANK_RING_MASK;
+}
+uint8_t HX711BANK_read(HX711BANK* self, struct hx711banksample* sample)
+{
+	if(self->head == self->tail)
+		return ZERO;
+	*sample=self->ring[self->tail];
+	self->tail=(self->tail+ONE) & HX711BANK_RING_MASK;
+	return ONE;
+}
+void HX711BANK_set_amplify(HX711BANK* self, uint8_t amplify)
+{
+	switch(amplify){
+		case 32:
+			self->pulses=2; //channel B
+			break;
+		case 64:
+			self->pulses=3; //channel A
+			break;
+		default:
+			self->pulses=ONE; //channel A 128
+			break;
+	}
+}
+void HX711BANK_power(HX711BANK* self, uint8_t on)
+// SCK high for more than 60us powers all chips down
+{
+	if(on){
+		*self->clkport&=~self->clkmask;
+		if(self->irq)
+			self->irq(ONE);
+	}else{
+		if(self->irq)
+			self->irq(ZERO);
+		*self->clkport|=self->clkmask;
+	}
+}
+/***Interrupt***/
+/***EOF***/
@@ -0,0 +1,72 @@
+/************************************************************************
+	HX711BANK
+Author: Sergio Santos
+	<sergio.salazar.santos@gmail.com>
+License: GNU General Public License
+Hardware: HX711 x N
+Date: 17102026
+Comment:
+	N HX711 on one data port with shared SCK, read in one clock pass
+************************************************************************/
+#ifndef _HX711BANK_H_
+	#define _HX711BANK_H_
+/***Library***/
+#include <inttypes.h>
+/***Constant & Macro***/
+#ifndef HX711BANK_CHANNELS
+	#define HX711BANK_CHANNELS 4 // maximum devices, up to 8
+#endif
+#ifndef HX711BANK_RING_SIZE
+	#define HX711BANK_RING_SIZE 4
+#endif
+#define HX711BANK_RING_MASK (HX711BANK_RING_SIZE - 1)
+#if (HX711BANK_RING_SIZE & HX711BANK_RING_MASK)
+	#error HX711BANK ring size is not a power of 2
+#endif
+#define HX711BANK_BITS 24
+/***Global Variable***/
+struct hx711banksample{
+	int32_t value[HX711BANK_CHANNELS]; // sign extended 24 bit, one per channel
+	uint8_t seq;
+};
+struct hx711bank{
+	volatile uint8_t* ddr;
+	volatile uint8_t* pin;
+	volatile uint8_t* port;
+	volatile uint8_t* clkddr;
+	volatile uint8_t* clkport;
+	uint8_t datamask; // all DOUT pins
+	uint8_t clkmask;
+	uint8_t bit[HX711BANK_CHANNELS]; // DOUT pin mask of each channel
+	uint8_t channels;
+	uint8_t pulses; // 25 to 27 clocks select next gain
+	void (*irq)(uint8_t on);
+	uint8_t snap[HX711BANK_BITS]; // port image at every clock
+	struct hx711banksample ring[HX711BANK_RING_SIZE];
+	volatile uint8_t head;
+	volatile uint8_t tail;
+	uint8_t seq;
+	uint8_t overrun;
+	/******/
+	void (*ready)(struct hx711bank* self);
+	uint8_t (*available)(struct hx711bank* self);
+	uint8_t (*read)(struct hx711bank* self, struct hx711banksample* sample);
+	void (*set_amplify)(struct hx711bank* self, uint8_t amplify);
+	void (*power)(struct hx711bank* self, uint8_t on);
+};
+typedef struct hx711bank HX711BANK;
+/***Header***/
+HX711BANK HX711BANKenable(volatile uint8_t *ddr, volatile uint8_t *pin, volatile uint8_t *port, uint8_t datamask, volatile uint8_t *clkddr, volatile uint8_t *clkport, uint8_t clkpin, void (*irq)(uint8_t on));
+#endif
+/***Comment***
+datamask has one bit per DOUT pin, channel 0 is the lowest bit set, pins past HX711BANK_CHANNELS are
+ignored. SCK may sit on the data port or on another one. ready returns at once until every DOUT is low,
+a chip that finishes first holds its result until the slowest one is done, then one pass of 24 clocks
+stores the whole port at each rising edge, so the clocking costs the same for one or eight chips, and
+the gain pulses follow at once. The bits are sorted into channels after SCK is back low, outside the
+timed part. Call ready from a timer interrupt faster than the output rate, or from a pin change
+interrupt on the data port, irq(0)/irq(1) turn it off and on as in HX711ACQ. Gain and power are shared
+by all chips. Clock all chips from one crystal on XI to keep the conversions in step, with the internal
+oscillators the bank runs at the rate of the slowest chip.
+*************/
+/***EOF***/
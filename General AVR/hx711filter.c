@@ -0,0 +1,143 @@
+/*************************************************************************
+	HX711FILTER
+Author: Sergio Santos
+	<sergio.salazar.santos@gmail.com>
+License: GNU General Public License
+Hardware: all
+Date: 17102026
+Comment:
+	Integer weighing pipeline, median, EMA, tare, zero tracking, Q16 scale
+************************************************************************/
+/***Library***/
+#include <inttypes.h>
+#include "hx711filter.h"
+/***Constant & Macro***/
+#define ZERO 0
+#define ONE 1
+#define HX711FILTER_ABS(x) (((x) < ZERO) ? -(x) : (x))
+/***Global File Variable***/
+/***Header***/
+void HX711FILTER_push(HX711FILTER* self, int32_t raw);
+int32_t HX711FILTER_net(HX711FILTER* self);
+int32_t HX711FILTER_grams(HX711FILTER* self);
+void HX711FILTER_tare(HX711FILTER* self);
+uint8_t HX711FILTER_calibrate(HX711FILTER* self, int32_t grams);
+int32_t HX711FILTER_median(HX711FILTER* self);
+/***Procedure & Function***/
+HX711FILTER HX711FILTERenable(int32_t scale, int32_t band, int32_t zeroband)
+{
+	//ALLOCAÇÂO MEMORIA PARA Estrutura
+	HX711FILTER filter;
+	//import parametros
+	filter.scale=scale;
+	filter.band=band;
+	filter.zeroband=zeroband;
+	//inic variables
+	filter.index=ZERO;
+	filter.count=ZERO;
+	filter.acc=ZERO;
+	filter.median=ZERO;
+	filter.value=ZERO;
+	filter.ref=ZERO;
+	filter.stablecount=ZERO;
+	filter.offset=ZERO;
+	filter.track=ZERO;
+	filter.status=HX711FILTER_TARE_PENDING; // auto tare
+	//Direccionar apontadores para PROTOTIPOS
+	filter.push=HX711FILTER_push;
+	filter.net=HX711FILTER_net;
+	filter.grams=HX711FILTER_grams;
+	filter.tare=HX711FILTER_tare;
+	filter.calibrate=HX711FILTER_calibrate;
+	//
+	return filter;
+}
+void HX711FILTER_push(HX711FILTER* self, int32_t raw)
+{
+	int32_t net;
+	/***median***/
+	self->window[self->index]=raw;
+	if(++self->index == HX711FILTER_MEDIAN)
+		self->index=ZERO;
+	if(self->count < HX711FILTER_MEDIAN)
+		self->count++;
+	self->median=HX711FILTER_median(self);
+	/***exponential average***/
+	if(self->count == ONE)
+		self->acc=self->median<<HX711FILTER_EMA_SHIFT;
+	else
+		self->acc+=self->median-(self->acc>>HX711FILTER_EMA_SHIFT);
+	self->value=self->acc>>HX711FILTER_EMA_SHIFT;
+	/***settled and stable***/
+	if(HX711FILTER_ABS(self->median-self->value) <= self->band){
+		self->status|=HX711FILTER_SETTLED;
+		if(HX711FILTER_ABS(self->value-self->ref) <= self->band){
+			if(self->stablecount < HX711FILTER_STABLE)
+				self->stablecount++;
+		}else{
+			self->ref=self->value;
+			self->stablecount=ZERO;
+		}
+	}else{
+		self->status&=~HX711FILTER_SETTLED;
+		self->ref=self->value;
+		self->stablecount=ZERO;
+	}
+	if(self->stablecount < HX711FILTER_STABLE){
+		self->status&=~HX711FILTER_STABLE_FLAG;
+		return;
+	}
+	self->status|=HX711FILTER_STABLE_FLAG;
+	/***tare and zero tracking***/
+	if(self->status & HX711FILTER_TARE_PENDING){
+		self->offset=self->value;
+		self->track=ZERO;
+		self->status&=~HX711FILTER_TARE_PENDING;
+		self->status|=HX711FILTER_TARED;
+		return;
+	}
+	net=self->value-self->offset;
+	if((self->status & HX711FILTER_TARED) && HX711FILTER_ABS(net) <= self->zeroband){
+		// 2^-TRACK_SHIFT of net per sample, the fraction stays in track and adds up
+		self->track+=net;
+		net=self->track/(ONE<<HX711FILTER_TRACK_SHIFT); // toward zero, same for either sign
+		self->offset+=net;
+		self->track-=net*(ONE<<HX711FILTER_TRACK_SHIFT);
+	}
+}
+int32_t HX711FILTER_net(HX711FILTER* self)
+{
+	return self->value-self->offset;
+}
+int32_t HX711FILTER_grams(HX711FILTER* self)
+{
+	return (int32_t)(((int64_t)(self->value-self->offset)*self->scale)>>16);
+}
+void HX711FILTER_tare(HX711FILTER* self)
+{
+	self->status|=HX711FILTER_TARE_PENDING;
+}
+uint8_t HX711FILTER_calibrate(HX711FILTER* self, int32_t grams)
+{
+	int32_t net=self->value-self->offset;
+	if(!(self->status & HX711FILTER_STABLE_FLAG) || !net)
+		return ZERO;
+	self->scale=(int32_t)(((int64_t)grams<<16)/net);
+	return ONE;
+}
+int32_t HX711FILTER_median(HX711FILTER* self)
+// insertion sort of a copy, window is small
+{
+	int32_t v[HX711FILTER_MEDIAN];
+	int32_t t;
+	uint8_t i, j;
+	for(i=ZERO;i<self->count;i++){
+		t=self->window[i];
+		for(j=i;j && v[j-ONE] > t;j--)
+			v[j]=v[j-ONE];
+		v[j]=t;
+	}
+	return v[self->count>>1];
+}
+/***Interrupt***/
+/***EOF***/
@@ -0,0 +1,75 @@
+/************************************************************************
+	HX711FILTER
+Author: Sergio Santos
+	<sergio.salazar.santos@gmail.com>
+License: GNU General Public License
+Hardware: all
+Date: 17102026
+Comment:
+	Integer weighing pipeline, median, EMA, tare, zero tracking, Q16 scale
+************************************************************************/
+#ifndef _HX711FILTER_H_
+	#define _HX711FILTER_H_
+/***Library***/
+#include <inttypes.h>
+/***Constant & Macro***/
+#ifndef HX711FILTER_MEDIAN
+	#define HX711FILTER_MEDIAN 5 // odd window
+#endif
+#if !(HX711FILTER_MEDIAN & 1)
+	#error HX711FILTER median window must be odd
+#endif
+#ifndef HX711FILTER_EMA_SHIFT
+	#define HX711FILTER_EMA_SHIFT 3 // alpha 1/8
+#endif
+#ifndef HX711FILTER_STABLE
+	#define HX711FILTER_STABLE 8 // samples inside band
+#endif
+#ifndef HX711FILTER_TRACK_SHIFT
+	#define HX711FILTER_TRACK_SHIFT 4 // zero tracking speed
+#endif
+/***status***/
+#define HX711FILTER_SETTLED 0x01
+#define HX711FILTER_STABLE_FLAG 0x02
+#define HX711FILTER_TARED 0x04
+#define HX711FILTER_TARE_PENDING 0x08
+/***Global Variable***/
+struct hx711filter{
+	int32_t window[HX711FILTER_MEDIAN];
+	uint8_t index;
+	uint8_t count;
+	int32_t acc; // EMA << HX711FILTER_EMA_SHIFT
+	int32_t median;
+	int32_t value; // filtered raw
+	int32_t ref; // stability reference
+	uint8_t stablecount;
+	int32_t band; // raw counts for settled and stable
+	int32_t zeroband; // raw counts around zero tracked
+	int32_t offset; // tare
+	int32_t track; // zero tracking fraction, 2^-TRACK_SHIFT counts
+	int32_t scale; // grams per count Q16
+	uint8_t status;
+	/******/
+	void (*push)(struct hx711filter* self, int32_t raw);
+	int32_t (*net)(struct hx711filter* self);
+	int32_t (*grams)(struct hx711filter* self);
+	void (*tare)(struct hx711filter* self);
+	uint8_t (*calibrate)(struct hx711filter* self, int32_t grams);
+};
+typedef struct hx711filter HX711FILTER;
+/***Header***/
+HX711FILTER HX711FILTERenable(int32_t scale, int32_t band, int32_t zeroband);
+#endif
+/***Comment***
+push takes every sample (from HX711ACQ read) and runs, all in integer: median of the last
+HX711FILTER_MEDIAN samples to drop spikes, exponential average with alpha 2^-EMA_SHIFT on the median,
+settled when median and average are within band, stable after HX711FILTER_STABLE settled samples that
+move less than band. The first stable value is the tare (auto tare), tare asks for a new one taken on
+the next stable sample. While stable and net within zeroband the tare follows the value by
+2^-TRACK_SHIFT of the difference per sample, the fraction below one count is kept in track and adds up,
+so slow drift of any size inside zeroband is tracked to zero and real loads are not.
+scale is grams per count in Q16 (65536 is 1 gram per count), grams is (net*scale)>>16 with one 64 bit
+product. calibrate with a known load on a stable reading sets scale=(grams<<16)/net, returns 0 when not
+stable or net is zero. band of 2 to 4 times the noise in counts is a good start.
+*************/
+/***EOF***/
@@ -10,33 +10,60 @@ Comment:
 /***Preamble Inic***/
 /***Library***/
 #include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <stddef.h>
 #include <inttypes.h>
 #include "keypad.h"
 /***Constant & Macro***/
-#define KEYPADLINES 4
-#define KEYPADCOLUMNS 4
+#ifndef GLOBAL_INTERRUPT_ENABLE
+	#define GLOBAL_INTERRUPT_ENABLE 7
+#endif
 #define ZERO 0
+#define ONE 1
+#define KEYPAD_NOKEY 0xFF
 /***Global File Variable***/
-volatile uint8_t *keypad_DDR;
+volatile uint8_t *keypad_DDR; // data (columns)
 volatile uint8_t *keypad_PIN;
 volatile uint8_t *keypad_PORT;
-struct keydata{
-	uint8_t line_1;
-	uint8_t line_2;
-	uint8_t line_3;
-	uint8_t line_4;
-}keypad_datai,keypad_dataf;
-char keypadvalue[KEYPADLINES][KEYPADCOLUMNS]=
+volatile uint8_t *keypad_lineDDR;
+volatile uint8_t *keypad_linePORT;
+uint8_t keypad_line[KEYPAD_MAX];
+uint8_t keypad_column[KEYPAD_MAX];
+uint8_t keypad_nline;
+uint8_t keypad_ncolumn;
+uint8_t keypad_linemask;
+const char* keypad_keymap; // PROGMEM nline x ncolumn
+const char keypadvalue[4][4] PROGMEM=
 {
 	{'1','2','3','A'},
 	{'4','5','6','B'},
 	{'7','8','9','C'},
 	{'*','0',35,'D'}
 };
+const uint8_t keypadline[4]={KEYPADLINE_1, KEYPADLINE_2, KEYPADLINE_3, KEYPADLINE_4};
+const uint8_t keypaddata[4]={KEYPADDATA_1, KEYPADDATA_2, KEYPADDATA_3, KEYPADDATA_4};
 char KEYPAD_string[KEYPADSTRINGSIZE+1];
 volatile uint8_t KEYPADSTRINGINDEX;
 struct keypadata data;
 char KEYPAD_char;
+/***interrupt mode***/
+void (*keypad_irq)(uint8_t on);
+volatile uint8_t keypad_active;
+uint8_t keypad_stable;
+uint8_t keypad_ghost;
+uint8_t keypad_raw[KEYPAD_MAX]; // last scan, bit per column
+uint8_t keypad_state[KEYPAD_MAX]; // debounced
+struct keyevent keypad_queue[KEYPAD_QUEUE_SIZE];
+volatile uint8_t keypad_head;
+volatile uint8_t keypad_tail;
+/***timed events***/
+uint16_t keypad_time; // debounced ticks while active
+uint16_t keypad_pressed; // time of held key press
+uint8_t keypad_held; // line<<3 | column, KEYPAD_NOKEY
+uint8_t keypad_chord;
+uint16_t keypad_hold;
+uint8_t keypad_repeat; // ticks to next repeat
+uint8_t keypad_period;
 //can not assign something outside a function
 /***Header***/
 /***getkey***/
@@ -47,135 +74,115 @@ struct keypadata KEYPAD_read(void);
 struct keypadata KEYPAD_get(void);
 /***flush***/
 void KEYPAD_flush(void);
+/***matrix***/
+uint8_t KEYPAD_bitmap(uint8_t* rows);
+uint8_t KEYPAD_ghosting(void);
+/***interrupt mode***/
+void KEYPAD_wake(void);
+void KEYPAD_tick(void);
+uint8_t KEYPAD_available(void);
+struct keyevent KEYPAD_event(void);
+uint8_t KEYPAD_scan(uint8_t* raw);
+uint8_t KEYPAD_ghostcheck(const uint8_t* raw);
+char KEYPAD_key(uint8_t l, uint8_t c);
+void KEYPAD_park(void);
+void KEYPAD_push(uint8_t type, char key, char key2);
+void KEYPAD_press(uint8_t l, uint8_t c);
+void KEYPAD_hold(void);
+uint8_t KEYPAD_down(void);
 /***lh***/
 uint8_t KEYPADlh(uint8_t xi, uint8_t xf);
 /***hl***/
 uint8_t KEYPADhl(uint8_t xi, uint8_t xf);
 /***Procedure & Function***/
 KEYPAD KEYPADenable(volatile uint8_t *ddr, volatile uint8_t *pin, volatile uint8_t *port)
+{
+	return KEYPADmatrixenable(ddr, port, ddr, pin, port, keypadline, 4, keypaddata, 4, &keypadvalue[0][0], NULL);
+}
+KEYPAD KEYPADirqenable(volatile uint8_t *ddr, volatile uint8_t *pin, volatile uint8_t *port, void (*irq)(uint8_t on))
+{
+	return KEYPADmatrixenable(ddr, port, ddr, pin, port, keypadline, 4, keypaddata, 4, &keypadvalue[0][0], irq);
+}
+KEYPAD KEYPADmatrixenable(volatile uint8_t *lineddr, volatile uint8_t *lineport,
+	volatile uint8_t *ddr, volatile uint8_t *pin, volatile uint8_t *port,
+	const uint8_t* line, uint8_t nline, const uint8_t* column, uint8_t ncolumn,
+	const char* keymap, void (*irq)(uint8_t on))
 {
 	//LOCAL VARIABLE
 	uint8_t tSREG;
+	uint8_t i;
 	tSREG=SREG;
+	SREG&=~(1<<GLOBAL_INTERRUPT_ENABLE);
 	data.character=' ';
 	//ALLOCAÇÂO MEMORIA PARA Estrutura
 	KEYPAD keypad;
 	//import parametros
+	keypad_lineDDR=lineddr;
+	keypad_linePORT=lineport;
 	keypad_DDR=ddr;
 	keypad_PIN=pin;
 	keypad_PORT=port;
+	keypad_nline=(nline > KEYPAD_MAX) ? KEYPAD_MAX : nline;
+	keypad_ncolumn=(ncolumn > KEYPAD_MAX) ? KEYPAD_MAX : ncolumn;
+	keypad_keymap=keymap;
+	keypad_irq=irq;
 	//inic variables
-	*keypad_DDR=(1<<KEYPADLINE_1) | (1<<KEYPADLINE_2) | (1<<KEYPADLINE_3) | (1<<KEYPADLINE_4);
-	*keypad_PORT=(1<<KEYPADDATA_1) | (1<<KEYPADDATA_2) | (1<<KEYPADDATA_3) | (1<<KEYPADDATA_4);
-	keypad_datai.line_1=keypad_dataf.line_1=(1<<KEYPADDATA_1) | (1<<KEYPADDATA_2) | (1<<KEYPADDATA_3) | (1<<KEYPADDATA_4);
-	keypad_datai.line_2=keypad_dataf.line_2=(1<<KEYPADDATA_1) | (1<<KEYPADDATA_2) | (1<<KEYPADDATA_3) | (1<<KEYPADDATA_4);
-	keypad_datai.line_3=keypad_dataf.line_3=(1<<KEYPADDATA_1) | (1<<KEYPADDATA_2) | (1<<KEYPADDATA_3) | (1<<KEYPADDATA_4);
-	keypad_datai.line_4=keypad_dataf.line_4=(1<<KEYPADDATA_1) | (1<<KEYPADDATA_2) | (1<<KEYPADDATA_3) | (1<<KEYPADDATA_4);
+	keypad_linemask=ZERO;
+	for(i=ZERO;i<keypad_nline;i++){
+		keypad_line[i]=line[i];
+		keypad_linemask|=(1<<line[i]);
+	}
+	for(i=ZERO;i<keypad_ncolumn;i++){
+		keypad_column[i]=column[i];
+		*keypad_DDR&=~(1<<column[i]);
+		*keypad_PORT|=(1<<column[i]); // pull up
+	}
+	for(i=ZERO;i<KEYPAD_MAX;i++)
+		keypad_state[i]=keypad_raw[i]=ZERO;
+	//Going to use pull down method, lines idle as input with pull up
+	*keypad_lineDDR&=~keypad_linemask;
+	*keypad_linePORT|=keypad_linemask;
 	KEYPADSTRINGINDEX=0;
+	keypad_active=ZERO;
+	keypad_stable=ZERO;
+	keypad_ghost=ZERO;
+	keypad_head=keypad_tail=ZERO;
+	keypad_held=KEYPAD_NOKEY;
+	keypad_chord=ZERO;
 	//Vtable
 	keypad.getkey=KEYPAD_getkey;
 	keypad.read=KEYPAD_read;
 	keypad.get=KEYPAD_get;
 	keypad.flush=KEYPAD_flush;
+	keypad.bitmap=KEYPAD_bitmap;
+	keypad.ghosting=KEYPAD_ghosting;
+	keypad.wake=KEYPAD_wake;
+	keypad.tick=KEYPAD_tick;
+	keypad.available=KEYPAD_available;
+	keypad.event=KEYPAD_event;
+	if(keypad_irq)
+		KEYPAD_park();
 	SREG=tSREG;
 	//
-	*keypad_PORT|=(1<<KEYPADLINE_1) | (1<<KEYPADLINE_2) | (1<<KEYPADLINE_3) | (1<<KEYPADLINE_4);
-	//Going to use pull down method.
 	return keypad;
 }
 char KEYPAD_getkey(void)
 {
-	uint8_t HL;
-	char c='\0';
-	uint8_t keypad_option;
-	for(keypad_option=0;keypad_option<KEYPADLINES;keypad_option++){
-		switch (keypad_option)
-		{
-			case 0: //line 1 index 0
-				*keypad_DDR|=(1<<KEYPADLINE_1);
-				*keypad_PORT&=~(1<<KEYPADLINE_1);
-				keypad_dataf.line_1=*keypad_PIN & ((1<<KEYPADDATA_1) | (1<<KEYPADDATA_2) | (1<<KEYPADDATA_3) | (1<<KEYPADDATA_4));
-				HL=KEYPADhl(keypad_datai.line_1,keypad_dataf.line_1);
-				keypad_datai.line_1=keypad_dataf.line_1;
-				if(HL){
-					//decode index line one column what ?
-					if(HL == (1<<KEYPADDATA_1))
-						c=keypadvalue[0][0];
-					if(HL == (1<<KEYPADDATA_2))
-						c=keypadvalue[0][1];
-					if(HL == (1<<KEYPADDATA_3))
-						c=keypadvalue[0][2];
-					if(HL == (1<<KEYPADDATA_4))
-						c=keypadvalue[0][3];
-				}
-				*keypad_DDR&=~(1<<KEYPADLINE_1);
-				*keypad_PORT|=(1<<KEYPADLINE_1);
-				break;
-			case 1: //line 2 index 1
-				*keypad_DDR|=(1<<KEYPADLINE_2);
-				*keypad_PORT&=~(1<<KEYPADLINE_2);
-				keypad_dataf.line_2=*keypad_PIN & ((1<<KEYPADDATA_1) | (1<<KEYPADDATA_2) | (1<<KEYPADDATA_3) | (1<<KEYPADDATA_4));
-				HL=KEYPADhl(keypad_datai.line_2,keypad_dataf.line_2);
-				keypad_datai.line_2=keypad_dataf.line_2;
-				if(HL){
-					//decode index line two column what ?
-					if(HL == (1<<KEYPADDATA_1))
-						c=keypadvalue[1][0];
-					if(HL == (1<<KEYPADDATA_2))
-						c=keypadvalue[1][1];
-					if(HL == (1<<KEYPADDATA_3))
-						c=keypadvalue[1][2];
-					if(HL == (1<<KEYPADDATA_4))
-						c=keypadvalue[1][3];
-				}
-				*keypad_DDR&=~(1<<KEYPADLINE_2);
-				*keypad_PORT|=(1<<KEYPADLINE_2);
-				break;
-			case 2: //line 3 index 2
-				*keypad_DDR|=(1<<KEYPADLINE_3);
-				*keypad_PORT&=~(1<<KEYPADLINE_3);
-				keypad_dataf.line_3=*keypad_PIN & ((1<<KEYPADDATA_1) | (1<<KEYPADDATA_2) | (1<<KEYPADDATA_3) | (1<<KEYPADDATA_4));
-				HL=KEYPADhl(keypad_datai.line_3,keypad_dataf.line_3);
-				keypad_datai.line_3=keypad_dataf.line_3;
-				if(HL){
-					//decode index line three column what ?
-					if(HL == (1<<KEYPADDATA_1))
-						c=keypadvalue[2][0];
-					if(HL == (1<<KEYPADDATA_2))
-						c=keypadvalue[2][1];
-					if(HL == (1<<KEYPADDATA_3))
-						c=keypadvalue[2][2];
-					if(HL == (1<<KEYPADDATA_4))
-						c=keypadvalue[2][3];
-				}
-				*keypad_DDR&=~(1<<KEYPADLINE_3);
-				*keypad_PORT|=(1<<KEYPADLINE_3);
-				break;
-			case 3: //line 4 index 3
-				*keypad_DDR|=(1<<KEYPADLINE_4);
-				*keypad_PORT&=~(1<<KEYPADLINE_4);
-				keypad_dataf.line_4=*keypad_PIN & ((1<<KEYPADDATA_1) | (1<<KEYPADDATA_2) | (1<<KEYPADDATA_3) | (1<<KEYPADDATA_4));
-				HL=KEYPADhl(keypad_datai.line_4,keypad_dataf.line_4);
-				keypad_datai.line_4=keypad_dataf.line_4;
-				if(HL){
-					//decode index line four column what ?
-					if(HL == (1<<KEYPADDATA_1))
-						c=keypadvalue[3][0];
-					if(HL == (1<<KEYPADDATA_2))
-						c=keypadvalue[3][1];
-					if(HL == (1<<KEYPADDATA_3))
-						c=keypadvalue[3][2];
-					if(HL == (1<<KEYPADDATA_4))
-						c=keypadvalue[3][3];
-				}
-				*keypad_DDR&=~(1<<KEYPADLINE_4);
-				*keypad_PORT|=(1<<KEYPADLINE_4);
-				break;
-			default:
-				break;
-		}
+	uint8_t raw[KEYPAD_MAX];
+	uint8_t l, c, LH;
+	char key='\0';
+	KEYPAD_scan(raw);
+	keypad_ghost=KEYPAD_ghostcheck(raw);
+	if(keypad_ghost)
+		return key; // ambiguous, keep last state
+	for(l=ZERO;l<keypad_nline;l++){
+		LH=KEYPADlh(keypad_state[l],raw[l]); // new presses
+		keypad_state[l]=raw[l];
+		for(c=ZERO;LH && !key;c++,LH>>=1)
+			if(LH & ONE)
+				key=KEYPAD_key(l, c);
 	}
-	return c;
+	return key;
 }
 /***read***/
 struct keypadata KEYPAD_read(void)
@@ -214,6 +221,209 @@ void KEYPAD_flush(void)
 	data.printstring="\0";
 	data.string="\0";
 }
+/***bitmap***/
+uint8_t KEYPAD_bitmap(uint8_t* rows)
+// debounced state, bit c of rows[l] is key l,c, returns keys down
+{
+	uint8_t l, bits, n=ZERO;
+	for(l=ZERO;l<keypad_nline;l++){
+		rows[l]=bits=keypad_state[l];
+		for(;bits;bits&=bits-ONE)
+			n++;
+	}
+	return n;
+}
+/***ghosting***/
+uint8_t KEYPAD_ghosting(void)
+{
+	return keypad_ghost;
+}
+/***wake***/
+void KEYPAD_wake(void)
+// Function to be used in the interrupt routine of the data pins
+{
+	if(!keypad_active){
+		if(keypad_irq)
+			keypad_irq(ZERO);
+		keypad_stable=ZERO;
+		keypad_active=ONE;
+	}
+}
+/***tick***/
+void KEYPAD_tick(void)
+// Function to be used in the timer interrupt routine
+{
+	uint8_t raw[KEYPAD_MAX];
+	uint8_t l, c, diff, down=ZERO, same=ONE;
+	if(!keypad_active)
+		return;
+	/***time runs every tick, bounce on another key does not stretch it***/
+	keypad_time++;
+	KEYPAD_hold();
+	KEYPAD_scan(raw);
+	for(l=ZERO;l<keypad_nline;l++){
+		if(raw[l] != keypad_raw[l])
+			same=ZERO;
+		keypad_raw[l]=raw[l];
+	}
+	if(!same){
+		keypad_stable=ZERO;
+		return;
+	}
+	if(keypad_stable < KEYPAD_DEBOUNCE)
+		if(++keypad_stable < KEYPAD_DEBOUNCE)
+			return;
+	/***debounced***/
+	keypad_ghost=KEYPAD_ghostcheck(raw);
+	if(keypad_ghost)
+		return; // ambiguous, keep last state until a key is released
+	for(l=ZERO;l<keypad_nline;l++){
+		diff=raw[l]^keypad_state[l];
+		for(c=ZERO;diff;c++,diff>>=1){
+			if(!(diff & ONE))
+				continue;
+			if(raw[l] & (1<<c)){
+				KEYPAD_press(l, c);
+			}else{
+				KEYPAD_push(KEYPAD_RELEASE, KEYPAD_key(l, c), '\0');
+				if(keypad_held == ((l<<3) | c))
+					keypad_held=KEYPAD_NOKEY;
+			}
+			keypad_state[l]^=(1<<c);
+		}
+		down|=raw[l];
+	}
+	if(!down){
+		keypad_held=KEYPAD_NOKEY;
+		keypad_chord=ZERO;
+		keypad_active=ZERO;
+		KEYPAD_park();
+	}
+}
+/***available***/
+uint8_t KEYPAD_available(void)
+{
+	return (keypad_head-keypad_tail) & KEYPAD_QUEUE_MASK;
+}
+/***event***/
+struct keyevent KEYPAD_event(void)
+{
+	struct keyevent e={KEYPAD_NONE, '\0', '\0'};
+	if(keypad_head != keypad_tail){
+		e=keypad_queue[keypad_tail];
+		keypad_tail=(keypad_tail+ONE) & KEYPAD_QUEUE_MASK;
+	}
+	return e;
+}
+/***scan***/
+uint8_t KEYPAD_scan(uint8_t* raw)
+// one line low at a time, bit c set when column c reads low, returns lines with keys
+{
+	uint8_t l, c, pin, any=ZERO;
+	*keypad_lineDDR&=~keypad_linemask;
+	*keypad_linePORT|=keypad_linemask;
+	for(l=ZERO;l<keypad_nline;l++){
+		*keypad_lineDDR|=(1<<keypad_line[l]);
+		*keypad_linePORT&=~(1<<keypad_line[l]);
+		pin=~*keypad_PIN;
+		raw[l]=ZERO;
+		for(c=ZERO;c<keypad_ncolumn;c++)
+			if(pin & (1<<keypad_column[c]))
+				raw[l]|=(1<<c);
+		*keypad_lineDDR&=~(1<<keypad_line[l]);
+		*keypad_linePORT|=(1<<keypad_line[l]);
+		if(raw[l])
+			any++;
+	}
+	return any;
+}
+/***ghostcheck***/
+uint8_t KEYPAD_ghostcheck(const uint8_t* raw)
+// two lines sharing two columns close a rectangle, the fourth corner may be a ghost
+{
+	uint8_t i, j, common;
+	for(i=ZERO;i<keypad_nline;i++){
+		if(!(raw[i] & (raw[i]-ONE)))
+			continue; // less than two keys on line
+		for(j=i+ONE;j<keypad_nline;j++){
+			common=raw[i] & raw[j];
+			if(common & (common-ONE))
+				return ONE;
+		}
+	}
+	return ZERO;
+}
+/***key***/
+char KEYPAD_key(uint8_t l, uint8_t c)
+{
+	return pgm_read_byte(keypad_keymap+l*keypad_ncolumn+c);
+}
+/***park***/
+void KEYPAD_park(void)
+// all lines low so any key pulls its data pin, rearm interrupt
+{
+	*keypad_lineDDR|=keypad_linemask;
+	*keypad_linePORT&=~keypad_linemask;
+	if(keypad_irq)
+		keypad_irq(ONE);
+}
+/***push***/
+void KEYPAD_push(uint8_t type, char key, char key2)
+{
+	uint8_t next=(keypad_head+ONE) & KEYPAD_QUEUE_MASK;
+	if(next == keypad_tail)
+		return; // full, drop newest
+	keypad_queue[keypad_head].type=type;
+	keypad_queue[keypad_head].key=key;
+	keypad_queue[keypad_head].key2=key2;
+	keypad_head=next;
+}
+/***press***/
+void KEYPAD_press(uint8_t l, uint8_t c)
+// press event, chord when a second key follows the held one in time
+{
+	char key=KEYPAD_key(l, c);
+	KEYPAD_push(KEYPAD_PRESS, key, '\0');
+	if(keypad_chord)
+		return;
+	if(keypad_held != KEYPAD_NOKEY && KEYPAD_down() == ONE && (uint16_t)(keypad_time-keypad_pressed) <= KEYPAD_CHORD){
+		KEYPAD_push(KEYPAD_CHORDPRESS, KEYPAD_key(keypad_held>>3, keypad_held & 7), key);
+		keypad_held=KEYPAD_NOKEY;
+		keypad_chord=ONE;
+		return;
+	}
+	keypad_held=(l<<3) | c;
+	keypad_pressed=keypad_time;
+	keypad_hold=ZERO;
+	keypad_period=KEYPAD_REPEAT_START;
+	keypad_repeat=KEYPAD_REPEAT_DELAY;
+}
+/***hold***/
+void KEYPAD_hold(void)
+// long press and accelerating repeat of the held key, once per tick
+{
+	char key;
+	if(keypad_held == KEYPAD_NOKEY)
+		return;
+	key=KEYPAD_key(keypad_held>>3, keypad_held & 7);
+	if(keypad_hold < KEYPAD_LONG)
+		if(++keypad_hold == KEYPAD_LONG)
+			KEYPAD_push(KEYPAD_LONGPRESS, key, '\0');
+	if(keypad_repeat)
+		if(!--keypad_repeat){
+			KEYPAD_push(KEYPAD_REPEAT, key, '\0');
+			keypad_repeat=keypad_period; // arm, then shrink the one after
+			keypad_period-=(keypad_period>>KEYPAD_REPEAT_ACCEL) ? keypad_period>>KEYPAD_REPEAT_ACCEL : ONE;
+			if(keypad_period < KEYPAD_REPEAT_MIN)
+				keypad_period=KEYPAD_REPEAT_MIN;
+		}
+}
+/***down***/
+uint8_t KEYPAD_down(void)
+{
+	uint8_t rows[KEYPAD_MAX];
+	return KEYPAD_bitmap(rows);
+}
 /***lh***/
 uint8_t KEYPADlh(uint8_t xi, uint8_t xf)
 {
@@ -25,14 +25,56 @@ Comment:
 #define KEYPADDATA_2 4
 #define KEYPADDATA_3 5
 #define KEYPADDATA_4 6
+#define KEYPAD_MAX 8 // lines and columns
 #define KEYPADSTRINGSIZE 20
 #define KEYPADENTERKEY 'D'
+/***interrupt mode***/
+#ifndef KEYPAD_QUEUE_SIZE
+	#define KEYPAD_QUEUE_SIZE 8
+#endif
+#define KEYPAD_QUEUE_MASK (KEYPAD_QUEUE_SIZE - 1)
+#if (KEYPAD_QUEUE_SIZE & KEYPAD_QUEUE_MASK)
+	#error KEYPAD queue size is not a power of 2
+#endif
+#ifndef KEYPAD_DEBOUNCE
+	#define KEYPAD_DEBOUNCE 4 // equal scans in a row
+#endif
+/***timed events, in ticks***/
+#ifndef KEYPAD_LONG
+	#define KEYPAD_LONG 100 // long press, 0 disables
+#endif
+#ifndef KEYPAD_REPEAT_DELAY
+	#define KEYPAD_REPEAT_DELAY 50 // first repeat, 0 disables
+#endif
+#ifndef KEYPAD_REPEAT_START
+	#define KEYPAD_REPEAT_START 20
+#endif
+#ifndef KEYPAD_REPEAT_MIN
+	#define KEYPAD_REPEAT_MIN 4
+#endif
+#ifndef KEYPAD_REPEAT_ACCEL
+	#define KEYPAD_REPEAT_ACCEL 3 // period shrinks by period>>ACCEL (at least 1) every repeat
+#endif
+#ifndef KEYPAD_CHORD
+	#define KEYPAD_CHORD 10 // second key window
+#endif
+#define KEYPAD_NONE 0
+#define KEYPAD_PRESS 1
+#define KEYPAD_RELEASE 2
+#define KEYPAD_LONGPRESS 3
+#define KEYPAD_REPEAT 4
+#define KEYPAD_CHORDPRESS 5
 /***Gloabl Variable***/
 struct keypadata{
 	char character;
 	char* printstring;
 	char* string;
 };
+struct keyevent{
+	uint8_t type;
+	char key;
+	char key2; // second key of a chord
+};
 /******/
 struct keypad{
 	//Local Variables
@@ -41,14 +83,48 @@ struct keypad{
 	struct keypadata (*read)(void);
 	struct keypadata (*get)(void);
 	void (*flush)(void);
+	/***matrix***/
+	uint8_t (*bitmap)(uint8_t* rows);
+	uint8_t (*ghosting)(void);
+	/***interrupt mode***/
+	void (*wake)(void);
+	void (*tick)(void);
+	uint8_t (*available)(void);
+	struct keyevent (*event)(void);
 };
 typedef struct keypad KEYPAD;
 /***Header***/
 KEYPAD KEYPADenable(volatile uint8_t *ddr, volatile uint8_t *pin, volatile uint8_t *port);
+KEYPAD KEYPADirqenable(volatile uint8_t *ddr, volatile uint8_t *pin, volatile uint8_t *port, void (*irq)(uint8_t on));
+KEYPAD KEYPADmatrixenable(volatile uint8_t *lineddr, volatile uint8_t *lineport,
+	volatile uint8_t *ddr, volatile uint8_t *pin, volatile uint8_t *port,
+	const uint8_t* line, uint8_t nline, const uint8_t* column, uint8_t ncolumn,
+	const char* keymap, void (*irq)(uint8_t on));
 #endif
 /************************************************************************
 The matrix buttons should have a diode in series so each button would only let current flow in one direction not allowing
 feedbacks. Little defect of keypads !
+Interrupt mode: KEYPADirqenable parks every line low, a key pulls its data pin low. Wire the data pins to
+an interrupt, INTn through an AND gate or diodes on the ATmega128, pin change on the ATmega328, irq(1)
+enables that interrupt and irq(0) disables it. Call wake from that interrupt routine and tick from a
+timer interrupt (2 to 10ms). wake turns the interrupt off and starts the scan, tick scans only while a
+key is down, a change counts after KEYPAD_DEBOUNCE equal scans and then press/release events go to the
+queue. With all keys released the lines go low again and irq(1) rearms the interrupt. The main loop
+only calls available and event, do not mix with getkey/read.
+Matrix: KEYPADmatrixenable takes up to 8 lines and 8 columns as pin number tables, lines on one port and
+data on another (or the same), keymap is a PROGMEM array of nline*ncolumn characters in line order.
+KEYPADenable and KEYPADirqenable are the 4x4 of the KEYPADLINE_/KEYPADDATA_ pins. Every scan reads all
+keys, bitmap gives the debounced state with bit c of rows[l] for key l,c and the number of keys down, so
+any number of keys is reported. Without diodes three keys on the corners of a rectangle also close the
+fourth, when two lines share two columns the scan is ambiguous, ghosting returns 1 and the state is kept
+until the ambiguity goes away.
+Timed events come from tick, so they need no polling, time counts every tick from the debounced press
+so bounce on other keys does not stretch it: the last key pressed alone is timed, LONGPRESS is
+sent once after KEYPAD_LONG ticks held, REPEAT after KEYPAD_REPEAT_DELAY and then every period, starting
+at KEYPAD_REPEAT_START and shrinking to KEYPAD_REPEAT_MIN. A second key pressed within KEYPAD_CHORD ticks
+of the first sends CHORDPRESS with key and key2 and stops the timing until every key is released. The
+application keeps the events it wants per key (REPEAT on arrows, LONGPRESS on menu keys). At 10ms tick
+the defaults are 1s long press, 500ms first repeat, 200ms to 40ms repeat and 100ms chord window.
 Simply Magic.
 ************************************************************************/
 /***EOF***/
@@ -0,0 +1,193 @@
+/*************************************************************************
+	KVSTORE
+Author: Sergio Santos
+	<sergio.salazar.santos@gmail.com>
+License: GNU General Public License
+Hardware: ATmega
+Date: 17102026
+Comment:
+	Wear levelled key value store, log structured over EEPROM vtable
+************************************************************************/
+/***Library***/
+#include <inttypes.h>
+#include <stddef.h>
+#include <string.h>
+#include "kvstore.h"
+#include "crc.h"
+/***Constant & Macro***/
+#define ZERO 0
+#define ONE 1
+#define KVSTORE_RECORD_SIZE sizeof(struct kvrecord)
+#define KVSTORE_CRC_SIZE offsetof(struct kvrecord, crc)
+#define KVSTORE_CRC_INIT 0xA5 // not CRC8_INIT, a cleared region (all 0x00) would check good
+/***Global File Variable***/
+CRC kvstore_crc;
+struct kvrecord kvstore_rec;
+/***Header***/
+uint8_t KVSTORE_get(KVSTORE* self, uint8_t key, void* value);
+uint8_t KVSTORE_set(KVSTORE* self, uint8_t key, const void* value);
+uint8_t KVSTORE_exist(KVSTORE* self, uint8_t key);
+void KVSTORE_format(KVSTORE* self);
+void KVSTORE_scan(KVSTORE* self);
+uint8_t KVSTORE_read(KVSTORE* self, uint16_t slot, struct kvrecord* rec);
+void KVSTORE_write(KVSTORE* self, uint16_t slot, struct kvrecord* rec);
+uint8_t KVSTORE_live(KVSTORE* self, uint16_t slot, struct kvrecord* rec);
+void KVSTORE_collect(KVSTORE* self);
+uint16_t KVSTORE_next(KVSTORE* self, uint16_t slot);
+/***Procedure & Function***/
+KVSTORE KVSTOREenable(EEPROM* eeprom, uint16_t base, uint16_t size)
+{
+	//ALLOCAÇÂO MEMORIA PARA Estrutura
+	KVSTORE kv;
+	kvstore_crc=CRCenable();
+	//import parametros
+	kv.eprom=eeprom;
+	kv.base=base;
+	kv.nslot=size/KVSTORE_RECORD_SIZE;
+	//Direccionar apontadores para PROTOTIPOS
+	kv.get=KVSTORE_get;
+	kv.set=KVSTORE_set;
+	kv.exist=KVSTORE_exist;
+	kv.format=KVSTORE_format;
+	//inic variables
+	KVSTORE_scan(&kv);
+	//
+	return kv;
+}
+uint8_t KVSTORE_get(KVSTORE* self, uint8_t key, void* value)
+{
+	if(key >= KVSTORE_MAX_KEYS || self->index[key] == KVSTORE_NONE)
+		return ZERO;
+	if(!KVSTORE_read(self, self->index[key], &kvstore_rec))
+		return ZERO;
+	memcpy(value, kvstore_rec.value, KVSTORE_VALUE_SIZE);
+	return ONE;
+}
+uint8_t KVSTORE_set(KVSTORE* self, uint8_t key, const void* value)
+{
+	if(key >= KVSTORE_MAX_KEYS || self->nslot < 3)
+		return ZERO;
+	if(self->index[key] != KVSTORE_NONE)
+		if(KVSTORE_read(self, self->index[key], &kvstore_rec))
+			if(!memcmp(kvstore_rec.value, value, KVSTORE_VALUE_SIZE))
+				return ONE; // unchanged, save a write
+	KVSTORE_collect(self);
+	if(self->free < 2)
+		return ZERO; // too many live keys for region
+	kvstore_rec.key=key;
+	memcpy(kvstore_rec.value, value, KVSTORE_VALUE_SIZE);
+	KVSTORE_write(self, self->head, &kvstore_rec);
+	self->index[key]=self->head;
+	self->head=KVSTORE_next(self, self->head);
+	self->free--;
+	return ONE;
+}
+uint8_t KVSTORE_exist(KVSTORE* self, uint8_t key)
+{
+	return key < KVSTORE_MAX_KEYS && self->index[key] != KVSTORE_NONE;
+}
+void KVSTORE_format(KVSTORE* self)
+{
+	uint16_t slot;
+	uint8_t i;
+	memset(&kvstore_rec, 0xFF, KVSTORE_RECORD_SIZE);
+	for(slot=ZERO; slot<self->nslot; slot++)
+		self->eprom->update_block(&kvstore_rec, (void*)(self->base+slot*KVSTORE_RECORD_SIZE), KVSTORE_RECORD_SIZE);
+	for(i=ZERO; i<KVSTORE_MAX_KEYS; i++)
+		self->index[i]=KVSTORE_NONE;
+	self->head=ZERO;
+	self->tail=ZERO;
+	self->free=self->nslot;
+	self->seq=ZERO;
+}
+void KVSTORE_scan(KVSTORE* self)
+/***
+Rebuild index, newest sequence wins, head follows newest record of all
+***/
+{
+	uint16_t slot;
+	uint16_t newest=KVSTORE_NONE;
+	uint16_t newseq=ZERO;
+	uint16_t seq;
+	uint8_t i;
+	for(i=ZERO; i<KVSTORE_MAX_KEYS; i++)
+		self->index[i]=KVSTORE_NONE;
+	for(slot=ZERO; slot<self->nslot; slot++){
+		if(!KVSTORE_read(self, slot, &kvstore_rec))
+			continue;
+		seq=kvstore_rec.seq;
+		i=kvstore_rec.key;
+		if(newest == KVSTORE_NONE || (int16_t)(seq-newseq) > 0){
+			newest=slot;
+			newseq=seq;
+		}
+		if(self->index[i] == KVSTORE_NONE){
+			self->index[i]=slot;
+		}else{
+			KVSTORE_read(self, self->index[i], &kvstore_rec);
+			if((int16_t)(seq-kvstore_rec.seq) > 0)
+				self->index[i]=slot;
+		}
+	}
+	if(newest == KVSTORE_NONE){
+		self->head=ZERO;
+		self->seq=ZERO;
+	}else{
+		self->head=KVSTORE_next(self, newest);
+		self->seq=newseq+ONE;
+	}
+	/***free run ends at first live record after head***/
+	self->tail=self->head;
+	for(self->free=ZERO; self->free<self->nslot; self->free++){
+		if(KVSTORE_live(self, self->tail, &kvstore_rec))
+			break;
+		self->tail=KVSTORE_next(self, self->tail);
+	}
+}
+uint8_t KVSTORE_read(KVSTORE* self, uint16_t slot, struct kvrecord* rec)
+{
+	self->eprom->read_block(rec, (const void*)(self->base+slot*KVSTORE_RECORD_SIZE), KVSTORE_RECORD_SIZE);
+	if(rec->key >= KVSTORE_MAX_KEYS)
+		return ZERO;
+	return kvstore_crc.crc8(KVSTORE_CRC_INIT, rec, KVSTORE_CRC_SIZE) == rec->crc;
+}
+void KVSTORE_write(KVSTORE* self, uint16_t slot, struct kvrecord* rec)
+{
+	rec->seq=self->seq++;
+	rec->crc=kvstore_crc.crc8(KVSTORE_CRC_INIT, rec, KVSTORE_CRC_SIZE);
+	self->eprom->update_block(rec, (void*)(self->base+slot*KVSTORE_RECORD_SIZE), KVSTORE_RECORD_SIZE);
+}
+uint8_t KVSTORE_live(KVSTORE* self, uint16_t slot, struct kvrecord* rec)
+{
+	if(!KVSTORE_read(self, slot, rec))
+		return ZERO;
+	return self->index[rec->key] == slot;
+}
+void KVSTORE_collect(KVSTORE* self)
+/***
+Keep two free slots ahead of head, live records at tail are copied to head
+***/
+{
+	uint16_t guard;
+	for(guard=ZERO; self->free < 2 && guard < self->nslot; guard++){
+		if(KVSTORE_live(self, self->tail, &kvstore_rec)){
+			if(!self->free)
+				return;
+			KVSTORE_write(self, self->head, &kvstore_rec);
+			self->index[kvstore_rec.key]=self->head;
+			self->head=KVSTORE_next(self, self->head);
+			self->free--;
+		}
+		self->tail=KVSTORE_next(self, self->tail);
+		self->free++;
+	}
+}
+uint16_t KVSTORE_next(KVSTORE* self, uint16_t slot)
+{
+	slot++;
+	if(slot >= self->nslot)
+		slot=ZERO;
+	return slot;
+}
+/***Interrupt***/
+/***EOF***/
@@ -0,0 +1,57 @@
+/************************************************************************
+	KVSTORE
+Author: Sergio Santos
+	<sergio.salazar.santos@gmail.com>
+License: GNU General Public License
+Hardware: ATmega
+Date: 17102026
+Comment:
+	Wear levelled key value store, log structured over EEPROM vtable
+************************************************************************/
+#ifndef _KVSTORE_H_
+	#define _KVSTORE_H_
+/***Library***/
+#include <inttypes.h>
+#include "eeprom.h"
+/***Constant & Macro***/
+#ifndef KVSTORE_MAX_KEYS
+	#define KVSTORE_MAX_KEYS 32
+#endif
+#define KVSTORE_VALUE_SIZE 4
+#define KVSTORE_NONE 0xFFFF
+/***Global Variable***/
+struct kvrecord{
+	uint8_t key;
+	uint16_t seq;
+	uint8_t value[KVSTORE_VALUE_SIZE];
+	uint8_t crc;
+};
+struct kvstore{
+	EEPROM* eprom;
+	uint16_t base; // first eeprom address of region
+	uint16_t nslot; // records that fit in region
+	uint16_t head; // next slot to write
+	uint16_t tail; // oldest slot not yet freed
+	uint16_t free; // dead slots from head to tail
+	uint16_t seq; // next sequence number
+	uint16_t index[KVSTORE_MAX_KEYS]; // slot of current record per key
+	/******/
+	uint8_t (*get)(struct kvstore* self, uint8_t key, void* value);
+	uint8_t (*set)(struct kvstore* self, uint8_t key, const void* value);
+	uint8_t (*exist)(struct kvstore* self, uint8_t key);
+	void (*format)(struct kvstore* self);
+};
+typedef struct kvstore KVSTORE;
+/***Header***/
+KVSTORE KVSTOREenable(EEPROM* eeprom, uint16_t base, uint16_t size);
+#endif
+/***Comment***
+Every set appends a record (key, sequence, 4 byte value, crc8 seeded 0xA5 so neither blank 0xFF nor
+cleared 0x00 eeprom reads as a record) at head, the older copy stays behind
+and becomes dead. Before head catches up with tail the live records at tail are copied forward, so
+every slot of the region is written once per lap whatever key is updated. The newest copy is kept
+valid until its replacement is written, a brown-out loses at most the record being written.
+Enable scans the region once to rebuild the index, get and set are O(1) afterwards.
+Values are 4 bytes (int32_t, uint32_t or float), at most nslot-2 keys can be live.
+*************/
+/***EOF***/
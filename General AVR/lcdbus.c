@@ -0,0 +1,336 @@
+/*************************************************************************
+	LCDBUS
+Author: Sergio Santos
+	<sergio.salazar.santos@gmail.com>
+License: GNU General Public License
+Hardware: HD44780 on port, PCF8574 backpack or 74HC595
+Date: 17102026
+Comment:
+	Pluggable transport for HD44780 LCD, one bus transaction per character
+************************************************************************/
+#ifndef F_CPU
+/***Mandatory to use util/delay.h***/
+	#define F_CPU 16000000UL
+#endif
+/***Library***/
+#include <avr/io.h>
+#include <util/delay.h>
+#include <stddef.h>
+#include <inttypes.h>
+#include "lcdbus.h"
+/***Constant & Macro***/
+#define ZERO 0
+//CMD RS
+#define INST 0
+#define DATA 1
+#define LCDBUS_PINS ((1<<RS)|(1<<RW)|(1<<EN)|(1<<DB4)|(1<<DB5)|(1<<DB6)|(1<<DB7))
+/***Global File Variable***/
+LCDBUS* lcdbus;
+/***Header***/
+void LCDBUS_port_write(LCDBUS* self, uint8_t c, uint8_t D_I);
+void LCDBUS_port_nibble(LCDBUS* self, uint8_t n, uint8_t D_I);
+void LCDBUS_port_wait(LCDBUS* self);
+#ifdef LCDBUS_PCF8574
+void LCDBUS_pcf8574_write(LCDBUS* self, uint8_t c, uint8_t D_I);
+void LCDBUS_pcf8574_nibble(LCDBUS* self, uint8_t n, uint8_t D_I);
+void LCDBUS_pcf8574_wait(LCDBUS* self);
+#endif
+void LCDBUS_hc595_write(LCDBUS* self, uint8_t c, uint8_t D_I);
+void LCDBUS_hc595_nibble(LCDBUS* self, uint8_t n, uint8_t D_I);
+void LCDBUS_hc595_wait(LCDBUS* self);
+void LCDBUS_backlight(LCDBUS* self, uint8_t on);
+uint8_t LCDBUS_pack(uint8_t n, uint8_t D_I);
+void LCDBUS_inic(void);
+void LCDBUS_write(char c, unsigned short D_I);
+char LCDBUS_read(unsigned short D_I);
+void LCDBUS_BF(void);
+void LCDBUS_putch(char c);
+char LCDBUS_getch(void);
+void LCDBUS_string(const char* s);
+void LCDBUS_string_size(const char* s, uint8_t size);
+void LCDBUS_hspace(uint8_t n);
+void LCDBUS_clear(void);
+void LCDBUS_gotoxy(unsigned int y, unsigned int x);
+void LCDBUS_reboot(void);
+/***Procedure & Function***/
+LCDBUS LCDBUSportenable(volatile uint8_t *ddr, volatile uint8_t *port)
+{
+	//ALLOCAÇÂO MEMORIA PARA Estrutura
+	LCDBUS bus;
+	//import parametros
+	bus.ddr=ddr;
+	bus.port=port;
+	bus.i2c=NULL;
+	bus.addr=ZERO;
+	bus.hc595=NULL;
+	//inic variables
+	bus.light=ZERO;
+	*bus.ddr|=LCDBUS_PINS;
+	*bus.port&=~LCDBUS_PINS;
+	//Direccionar apontadores para PROTOTIPOS
+	bus.write=LCDBUS_port_write;
+	bus.nibble=LCDBUS_port_nibble;
+	bus.wait=LCDBUS_port_wait;
+	bus.backlight=LCDBUS_backlight;
+	//
+	return bus;
+}
+#ifdef LCDBUS_PCF8574
+LCDBUS LCDBUSpcf8574enable(I2C* i2c, uint8_t addr)
+{
+	//ALLOCAÇÂO MEMORIA PARA Estrutura
+	LCDBUS bus;
+	//import parametros
+	bus.ddr=NULL;
+	bus.port=NULL;
+	bus.i2c=i2c;
+	bus.addr=addr;
+	bus.hc595=NULL;
+	//inic variables
+	bus.light=(1<<LCDBUS_BACKLIGHT);
+	//Direccionar apontadores para PROTOTIPOS
+	bus.write=LCDBUS_pcf8574_write;
+	bus.nibble=LCDBUS_pcf8574_nibble;
+	bus.wait=LCDBUS_pcf8574_wait;
+	bus.backlight=LCDBUS_backlight;
+	//
+	return bus;
+}
+#endif
+LCDBUS LCDBUShc595enable(HC595SPI* hc595, uint8_t index)
+{
+	//ALLOCAÇÂO MEMORIA PARA Estrutura
+	LCDBUS bus;
+	//import parametros
+	bus.ddr=NULL;
+	bus.port=NULL;
+	bus.i2c=NULL;
+	bus.addr=index; // register in chain
+	bus.hc595=hc595;
+	//inic variables
+	bus.light=ZERO;
+	//Direccionar apontadores para PROTOTIPOS
+	bus.write=LCDBUS_hc595_write;
+	bus.nibble=LCDBUS_hc595_nibble;
+	bus.wait=LCDBUS_hc595_wait;
+	bus.backlight=LCDBUS_backlight;
+	//
+	return bus;
+}
+/***port***/
+void LCDBUS_port_write(LCDBUS* self, uint8_t c, uint8_t D_I)
+{
+	LCDBUS_port_nibble(self, c>>4, D_I);
+	LCDBUS_port_nibble(self, c, D_I);
+}
+void LCDBUS_port_nibble(LCDBUS* self, uint8_t n, uint8_t D_I)
+{
+	*self->port=(*self->port & ~LCDBUS_PINS) | LCDBUS_pack(n, D_I);
+	*self->port|=(1<<EN);
+	*self->port&=~(1<<EN);
+}
+void LCDBUS_port_wait(LCDBUS* self)
+{
+	_delay_us(43);
+}
+#ifdef LCDBUS_PCF8574
+/***pcf8574***/
+void LCDBUS_pcf8574_write(LCDBUS* self, uint8_t c, uint8_t D_I)
+{
+	uint8_t hi, lo;
+	hi=LCDBUS_pack(c>>4, D_I) | self->light;
+	lo=LCDBUS_pack(c, D_I) | self->light;
+	self->i2c->Start();
+	self->i2c->Write(self->addr<<1);
+	self->i2c->Write(hi); // RS setup before EN
+	self->i2c->Write(hi | (1<<EN));
+	self->i2c->Write(hi);
+	self->i2c->Write(lo | (1<<EN));
+	self->i2c->Write(lo);
+	self->i2c->Stop();
+}
+void LCDBUS_pcf8574_nibble(LCDBUS* self, uint8_t n, uint8_t D_I)
+{
+	n=LCDBUS_pack(n, D_I) | self->light;
+	self->i2c->Start();
+	self->i2c->Write(self->addr<<1);
+	self->i2c->Write(n);
+	self->i2c->Write(n | (1<<EN));
+	self->i2c->Write(n);
+	self->i2c->Stop();
+}
+void LCDBUS_pcf8574_wait(LCDBUS* self)
+{
+	// transaction time exceeds execution time
+}
+#endif
+/***74hc595***/
+void LCDBUS_hc595_write(LCDBUS* self, uint8_t c, uint8_t D_I)
+{
+	uint8_t seq[5];
+	seq[0]=LCDBUS_pack(c>>4, D_I); // RS setup before EN
+	seq[1]=seq[0] | (1<<EN);
+	seq[2]=seq[0];
+	seq[4]=LCDBUS_pack(c, D_I);
+	seq[3]=seq[4] | (1<<EN);
+	self->hc595->stream(self->hc595, self->addr, seq, 5);
+}
+void LCDBUS_hc595_nibble(LCDBUS* self, uint8_t n, uint8_t D_I)
+{
+	uint8_t seq[3];
+	seq[0]=LCDBUS_pack(n, D_I);
+	seq[1]=seq[0] | (1<<EN);
+	seq[2]=seq[0];
+	self->hc595->stream(self->hc595, self->addr, seq, 3);
+}
+void LCDBUS_hc595_wait(LCDBUS* self)
+{
+	_delay_us(40);
+}
+/***common***/
+void LCDBUS_backlight(LCDBUS* self, uint8_t on)
+{
+	#ifdef LCDBUS_PCF8574
+	if(self->i2c){
+		self->light=on ? (1<<LCDBUS_BACKLIGHT) : ZERO;
+		self->i2c->Start();
+		self->i2c->Write(self->addr<<1);
+		self->i2c->Write(self->light);
+		self->i2c->Stop();
+	}
+	#endif
+}
+uint8_t LCDBUS_pack(uint8_t n, uint8_t D_I)
+// nibble and RS on lcd.h pin positions
+{
+	uint8_t b=ZERO;
+	if(D_I) b|=(1<<RS);
+	if(n & 0x08) b|=(1<<DB7);
+	if(n & 0x04) b|=(1<<DB6);
+	if(n & 0x02) b|=(1<<DB5);
+	if(n & 0x01) b|=(1<<DB4);
+	return b;
+}
+/***LCD on bus***/
+LCD0 LCDBUSlcdenable(LCDBUS* bus)
+{
+	//ALLOCAÇÂO MEMORIA PARA Estrutura
+	LCD0 lcd;
+	//import parametros
+	lcdbus=bus;
+	//Direccionar apontadores para PROTOTIPOS
+	lcd.write=LCDBUS_write;
+	lcd.read=LCDBUS_read;
+	lcd.BF=LCDBUS_BF;
+	lcd.putch=LCDBUS_putch;
+	lcd.getch=LCDBUS_getch;
+	lcd.string=LCDBUS_string;
+	lcd.string_size=LCDBUS_string_size; // RAW
+	lcd.hspace=LCDBUS_hspace;
+	lcd.clear=LCDBUS_clear;
+	lcd.gotoxy=LCDBUS_gotoxy;
+	lcd.reboot=LCDBUS_reboot;
+	//LCD INIC
+	LCDBUS_inic();
+	//
+	return lcd;
+}
+void LCDBUS_inic(void)
+{
+	/***INICIALIZACAO LCD**datasheet*/
+	_delay_ms(40);
+	lcdbus->nibble(lcdbus, 0x03, INST); //function set 8 bit
+	_delay_ms(4.1);
+	lcdbus->nibble(lcdbus, 0x03, INST);
+	_delay_us(100);
+	lcdbus->nibble(lcdbus, 0x03, INST);
+	_delay_us(39);
+	lcdbus->nibble(lcdbus, 0x02, INST); //4 bit
+	_delay_us(39);
+	LCDBUS_write(0x28,INST); //function set
+	LCDBUS_BF();
+	LCDBUS_write(0x0C,INST);// display on/off control
+	LCDBUS_BF();
+	LCDBUS_write(0x01,INST);// clear display
+	_delay_ms(1.53);
+	LCDBUS_write(0x06,INST);// entry mode set
+	LCDBUS_BF();
+	/***INICIALIZATION END***/
+}
+void LCDBUS_write(char c, unsigned short D_I)
+{
+	lcdbus->write(lcdbus, c, D_I);
+}
+char LCDBUS_read(unsigned short D_I)
+{
+	return ZERO; // RW tied low
+}
+void LCDBUS_BF(void)
+{
+	lcdbus->wait(lcdbus);
+}
+void LCDBUS_putch(char c)
+{
+	LCDBUS_write(c,DATA);
+	LCDBUS_BF();
+}
+char LCDBUS_getch(void)
+{
+	return ZERO;
+}
+void LCDBUS_string(const char* s)
+{
+	while(*s)
+		LCDBUS_putch(*(s++));
+}
+void LCDBUS_string_size(const char* s, uint8_t size)
+{
+	uint8_t pos=0;
+	while(*s){
+		pos++;
+		if(pos>size) // 1 TO SIZE+1
+			break;
+		LCDBUS_putch(*(s++));
+	}
+	while(pos<size){ // TO SIZE
+		pos++;
+		LCDBUS_putch(' ');
+	}
+}
+void LCDBUS_hspace(uint8_t n)
+{
+	for(;n;n--)
+		LCDBUS_putch(' ');
+}
+void LCDBUS_clear(void)
+{
+	LCDBUS_write(0x01,INST);
+	_delay_ms(1.53);
+}
+void LCDBUS_gotoxy(unsigned int y, unsigned int x)
+{
+	switch(y){
+		case 0:
+			LCDBUS_write((0x80+x),INST);
+			break;
+		case 1:
+			LCDBUS_write((0xC0+x),INST);
+			break;
+		case 2:
+			LCDBUS_write((0x94+x),INST);
+			break;
+		case 3:
+			LCDBUS_write((0xD4+x),INST);
+			break;
+		default:
+			return;
+	}
+	LCDBUS_BF();
+}
+void LCDBUS_reboot(void)
+// no detect pin on a bus, initialize again
+{
+	LCDBUS_inic();
+}
+/***Interrupt***/
+/***EOF***/
@@ -0,0 +1,64 @@
+/************************************************************************
+	LCDBUS
+Author: Sergio Santos
+	<sergio.salazar.santos@gmail.com>
+License: GNU General Public License
+Hardware: HD44780 on port, PCF8574 backpack or 74HC595
+Date: 17102026
+Comment:
+	Pluggable transport for HD44780 LCD, one bus transaction per character
+************************************************************************/
+#ifndef _LCDBUS_H_
+	#define _LCDBUS_H_
+/***Library***/
+#include <inttypes.h>
+#include "lcd.h"
+#include "74hc595.h"
+#if defined(__AVR_ATmega64__) || defined(__AVR_ATmega128__)
+	#include "atmega128i2c.h"
+	#define LCDBUS_PCF8574
+#elif defined(__AVR_ATmega328__) || defined(__AVR_ATmega328P__)
+	#include "atmega328i2c.h"
+	#define LCDBUS_PCF8574
+#endif
+struct twi; // I2C vtable, only the PCF8574 transport needs it
+/***Constant & Macro***/
+#define LCDBUS_PCF8574_ADDR 0x27 // PCF8574A backpack is 0x3F
+#define LCDBUS_BACKLIGHT NC // PCF8574 P3
+/***Global Variable***/
+struct lcdbus{
+	volatile uint8_t* ddr; // direct port
+	volatile uint8_t* port;
+	struct twi* i2c; // PCF8574 backpack
+	uint8_t addr; // I2C address or register index in 74HC595 chain
+	uint8_t light;
+	HC595SPI* hc595; // 74HC595 with latch on EN
+	/******/
+	void (*write)(struct lcdbus* self, uint8_t c, uint8_t D_I);
+	void (*nibble)(struct lcdbus* self, uint8_t n, uint8_t D_I);
+	void (*wait)(struct lcdbus* self);
+	void (*backlight)(struct lcdbus* self, uint8_t on);
+};
+typedef struct lcdbus LCDBUS;
+/***Header***/
+LCDBUS LCDBUSportenable(volatile uint8_t *ddr, volatile uint8_t *port);
+#ifdef LCDBUS_PCF8574
+LCDBUS LCDBUSpcf8574enable(I2C* i2c, uint8_t addr);
+#endif
+LCDBUS LCDBUShc595enable(HC595SPI* hc595, uint8_t index);
+LCD0 LCDBUSlcdenable(LCDBUS* bus);
+#endif
+/***Comment***
+Bit n of the byte sent to the expander is pin n of lcd.h (RS 0, RW 1, EN 2, NC 3, DB4 to DB7 4 to 7),
+which is the wiring of the common PCF8574 backpack with the backlight on P3. The PCF8574 transport sends
+both nibbles with their EN strobes in one Start/Write/Stop, address and 5 bytes, about 630us at 100KHz
+(160us at 400KHz) which already covers the 37us execution time, so wait is empty. The 74HC595 transport
+uses the same layout on register index of a HC595SPI chain, other registers of the chain keep their
+value, one character is one stream call of the same 5 states latched back to back, 5 frames of the
+chain, about 6us at F_CPU/2 for a single register. RW must be tied low on serial transports, read and
+getch of the LCD on top of a bus return 0 and the busy flag is replaced by the execution time in wait.
+LCDBUSlcdenable returns the usual LCD vtable for the application, LCDFB and GLYPH, one bus LCD per
+program like LCD0 and LCD1. The PCF8574 transport is built only where an I2C library exists
+(ATmega64/128 and ATmega328), port and 74HC595 build on every part. reboot initializes again.
+*************/
+/***EOF***/
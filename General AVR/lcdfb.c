@@ -0,0 +1,193 @@
+/*************************************************************************
+	LCDFB
+Author: Sergio Santos
+	<sergio.salazar.santos@gmail.com>
+License: GNU General Public License
+Hardware: all
+Date: 17102026
+Comment:
+	Shadow framebuffer for HD44780 LCD, flush sends changed cells only
+************************************************************************/
+/***Library***/
+#include <avr/io.h>
+#include <inttypes.h>
+#include "lcdfb.h"
+/***Constant & Macro***/
+#ifndef GLOBAL_INTERRUPT_ENABLE
+	#define GLOBAL_INTERRUPT_ENABLE 7
+#endif
+#define ZERO 0
+#define INST 0
+/***Global File Variable***/
+// DDRAM address of column zero, same as LCD gotoxy
+const uint8_t LCDFB_ROW_ADDR[4]={0x00, 0x40, 0x14, 0x54};
+const uint8_t LCDFB_ROW_ORDER[4]={0, 2, 1, 3}; // rows by rising DDRAM address
+/***Header***/
+void LCDFB_gotoxy(LCDFB* self, unsigned int y, unsigned int x);
+void LCDFB_putch(LCDFB* self, char c);
+void LCDFB_string(LCDFB* self, const char* s);
+void LCDFB_string_size(LCDFB* self, const char* s, uint8_t size);
+void LCDFB_hspace(LCDFB* self, uint8_t n);
+void LCDFB_clear(LCDFB* self);
+void LCDFB_invalidate(LCDFB* self);
+uint8_t LCDFB_flush(LCDFB* self);
+uint16_t LCDFB_step(LCDFB* self);
+uint8_t LCDFB_changed(LCDFB* self);
+uint8_t LCDFB_next(uint8_t addr);
+/***Procedure & Function***/
+LCDFB LCDFBenable(struct dspl* lcd, uint8_t rows, uint8_t cols)
+{
+	//ALLOCAÇÂO MEMORIA PARA Estrutura
+	LCDFB fb;
+	uint8_t y, x;
+	//import parametros
+	fb.lcd=lcd;
+	fb.rows=(rows > LCDFB_ROWS) ? LCDFB_ROWS : rows;
+	fb.cols=(cols > LCDFB_COLUMNS) ? LCDFB_COLUMNS : cols;
+	//inic variables
+	fb.y=ZERO;
+	fb.x=ZERO;
+	fb.addr=LCDFB_UNKNOWN;
+	for(y=ZERO;y<LCDFB_ROWS;y++)
+		for(x=ZERO;x<LCDFB_COLUMNS;x++)
+			fb.frame[y][x]=' ';
+	//Direccionar apontadores para PROTOTIPOS
+	fb.gotoxy=LCDFB_gotoxy;
+	fb.putch=LCDFB_putch;
+	fb.string=LCDFB_string;
+	fb.string_size=LCDFB_string_size;
+	fb.hspace=LCDFB_hspace;
+	fb.clear=LCDFB_clear;
+	fb.invalidate=LCDFB_invalidate;
+	fb.flush=LCDFB_flush;
+	fb.step=LCDFB_step;
+	fb.changed=LCDFB_changed;
+	LCDFB_invalidate(&fb);
+	//
+	return fb;
+}
+void LCDFB_gotoxy(LCDFB* self, unsigned int y, unsigned int x)
+{
+	self->y=y;
+	self->x=x;
+}
+void LCDFB_putch(LCDFB* self, char c)
+{
+	uint8_t cell, tSREG;
+	if(self->y < self->rows && self->x < self->cols){
+		if(self->frame[self->y][self->x] != c){
+			self->frame[self->y][self->x]=c;
+			cell=self->y*LCDFB_COLUMNS+self->x;
+			tSREG=SREG;
+			SREG&=~(1<<GLOBAL_INTERRUPT_ENABLE);
+			self->dirty[cell>>3]|=(1<<(cell & 7));
+			SREG=tSREG;
+		}
+		self->x++;
+	}
+}
+void LCDFB_string(LCDFB* self, const char* s)
+{
+	while(*s)
+		LCDFB_putch(self, *(s++));
+}
+void LCDFB_string_size(LCDFB* self, const char* s, uint8_t size)
+{
+	uint8_t pos;
+	for(pos=ZERO; pos<size; pos++)
+		LCDFB_putch(self, *s ? *(s++) : ' ');
+}
+void LCDFB_hspace(LCDFB* self, uint8_t n)
+{
+	for(;n;n--)
+		LCDFB_putch(self, ' ');
+}
+void LCDFB_clear(LCDFB* self)
+{
+	uint8_t y;
+	for(y=ZERO;y<self->rows;y++){
+		self->y=y;
+		self->x=ZERO;
+		LCDFB_hspace(self, self->cols);
+	}
+	self->y=ZERO;
+	self->x=ZERO;
+}
+void LCDFB_invalidate(LCDFB* self)
+{
+	uint8_t i;
+	for(i=ZERO;i<sizeof(self->dirty);i++)
+		self->dirty[i]=0xFF;
+	self->addr=LCDFB_UNKNOWN;
+}
+uint8_t LCDFB_flush(LCDFB* self)
+{
+	uint16_t code;
+	uint8_t count=ZERO;
+	while((code=LCDFB_step(self)) != LCDFB_IDLE){
+		if(code & LCDFB_DATA){
+			self->lcd->putch(code);
+			count++;
+		}else{
+			self->lcd->write(code, INST);
+			self->lcd->BF();
+		}
+	}
+	return count;
+}
+uint16_t LCDFB_step(LCDFB* self)
+// next byte for the LCD, address instruction only when counter is elsewhere
+{
+	uint8_t i, r, y, x, addr, mask;
+	uint8_t cell;
+	for(r=ZERO;r<LCDFB_ROWS;r++){
+		y=LCDFB_ROW_ORDER[r];
+		if(y >= self->rows)
+			continue;
+		cell=y*LCDFB_COLUMNS;
+		for(x=ZERO;x<self->cols;x++, cell++){
+			i=cell>>3;
+			if(!self->dirty[i]){
+				/***skip to next byte of the bitmap***/
+				x+=7-(cell & 7);
+				cell+=7-(cell & 7);
+				continue;
+			}
+			mask=(1<<(cell & 7));
+			if(!(self->dirty[i] & mask))
+				continue;
+			addr=LCDFB_ROW_ADDR[y]+x;
+			if(addr != self->addr){
+				self->addr=addr;
+				return (0x80 | addr); // set DDRAM address
+			}
+			self->dirty[i]&=~mask;
+			self->addr=LCDFB_next(addr);
+			return (LCDFB_DATA | (uint8_t)self->frame[y][x]);
+		}
+	}
+	/***what is left is outside the display***/
+	for(i=ZERO;i<sizeof(self->dirty);i++)
+		self->dirty[i]=ZERO;
+	return LCDFB_IDLE;
+}
+uint8_t LCDFB_changed(LCDFB* self)
+{
+	uint8_t i;
+	for(i=ZERO;i<sizeof(self->dirty);i++)
+		if(self->dirty[i])
+			return 1;
+	return ZERO;
+}
+uint8_t LCDFB_next(uint8_t addr)
+// HD44780 address counter after a data write, two line mode
+{
+	addr++;
+	if(addr == 0x28)
+		addr=0x40;
+	else if(addr == 0x68)
+		addr=0x00;
+	return addr;
+}
+/***Interrupt***/
+/***EOF***/
@@ -0,0 +1,63 @@
+/************************************************************************
+	LCDFB
+Author: Sergio Santos
+	<sergio.salazar.santos@gmail.com>
+License: GNU General Public License
+Hardware: all
+Date: 17102026
+Comment:
+	Shadow framebuffer for HD44780 LCD, flush sends changed cells only
+************************************************************************/
+#ifndef _LCDFB_H_
+	#define _LCDFB_H_
+/***Library***/
+#include <inttypes.h>
+#include "lcd.h"
+/***Constant & Macro***/
+#ifndef LCDFB_ROWS
+	#define LCDFB_ROWS 4
+#endif
+#ifndef LCDFB_COLUMNS
+	#define LCDFB_COLUMNS 20
+#endif
+#define LCDFB_CELLS (LCDFB_ROWS * LCDFB_COLUMNS)
+/***step codes***/
+#define LCDFB_DATA 0x0100 // bit set for character, clear for instruction
+#define LCDFB_IDLE 0xFFFF // nothing left to send
+#define LCDFB_UNKNOWN 0xFF // LCD address counter not known
+/***Global Variable***/
+struct lcdfb{
+	struct dspl* lcd;
+	uint8_t rows;
+	uint8_t cols;
+	uint8_t y; // draw cursor
+	uint8_t x;
+	uint8_t addr; // lcd DDRAM address counter
+	char frame[LCDFB_ROWS][LCDFB_COLUMNS];
+	uint8_t dirty[(LCDFB_CELLS + 7) / 8];
+	/******/
+	void (*gotoxy)(struct lcdfb* self, unsigned int y, unsigned int x);
+	void (*putch)(struct lcdfb* self, char c);
+	void (*string)(struct lcdfb* self, const char* s);
+	void (*string_size)(struct lcdfb* self, const char* s, uint8_t size);
+	void (*hspace)(struct lcdfb* self, uint8_t n);
+	void (*clear)(struct lcdfb* self);
+	void (*invalidate)(struct lcdfb* self);
+	uint8_t (*flush)(struct lcdfb* self);
+	uint16_t (*step)(struct lcdfb* self);
+	uint8_t (*changed)(struct lcdfb* self);
+};
+typedef struct lcdfb LCDFB;
+/***Header***/
+LCDFB LCDFBenable(struct dspl* lcd, uint8_t rows, uint8_t cols);
+#endif
+/***Comment***
+Draw calls only touch RAM, a cell is marked dirty when its character changes. flush walks the cells
+in DDRAM address order (rows 0, 2, 1, 3 on a 4 line display) and follows the LCD address counter, gotoxy is only sent when the next dirty
+cell is not where the counter already points. Text past the last column is clipped. Call invalidate
+after the LCD reboots so the next flush redraws everything.
+step hands out one LCD byte at a time (DDRAM address instruction or LCDFB_DATA|character) for drivers
+that send from a timer tick, flush is step sent through the blocking LCD vtable. Draw calls set the dirty
+bit with interrupts off so step may run inside an interrupt routine.
+*************/
+/***EOF***/
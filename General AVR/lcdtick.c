@@ -0,0 +1,220 @@
+/*************************************************************************
+	LCDTICK
+Author: Sergio Santos
+	<sergio.salazar.santos@gmail.com>
+License: GNU General Public License
+Hardware: all
+Date: 17102026
+Comment:
+	Non blocking HD44780 driver, one nibble per timer tick
+************************************************************************/
+/***Library***/
+#include <avr/io.h>
+#include <stddef.h>
+#include <inttypes.h>
+#include "lcdtick.h"
+/***Constant & Macro***/
+#ifndef GLOBAL_INTERRUPT_ENABLE
+	#define GLOBAL_INTERRUPT_ENABLE 7
+#endif
+#define ZERO 0
+#define ONE 1
+//CMD RS
+#define INST 0
+#define DATA 1
+//low nibble flags
+#define LCDTICK_LOW_PENDING 0x10
+#define LCDTICK_LOW_RS 0x20
+#define LCDTICK_LOW_SLOW 0x40
+//datasheet times in us
+#define LCDTICK_POWERUP_US 40000
+#define LCDTICK_EXEC_US 43
+#define LCDTICK_CLEAR_US 1530
+#define LCDTICK_LINE 40 // DDRAM cells per line
+/***Global File Variable***/
+// 8 bit function set three times then switch to 4 bit
+const uint8_t LCDTICK_INIT_NIBBLE[4]={0x03, 0x03, 0x03, 0x02};
+const uint16_t LCDTICK_INIT_US[4]={4100, 100, LCDTICK_EXEC_US, LCDTICK_EXEC_US};
+const uint8_t LCDTICK_ROW_ADDR[4]={0x80, 0xC0, 0x94, 0xD4};
+/***Header***/
+void LCDTICK_tick(LCDTICK* self);
+uint8_t LCDTICK_command(LCDTICK* self, uint8_t inst);
+uint8_t LCDTICK_putch(LCDTICK* self, char c);
+uint8_t LCDTICK_string(LCDTICK* self, const char* s);
+uint8_t LCDTICK_gotoxy(LCDTICK* self, unsigned int y, unsigned int x);
+uint8_t LCDTICK_clear(LCDTICK* self);
+void LCDTICK_attach(LCDTICK* self, LCDFB* fb);
+uint8_t LCDTICK_space(LCDTICK* self);
+uint8_t LCDTICK_idle(LCDTICK* self);
+uint8_t LCDTICK_push(LCDTICK* self, uint16_t code);
+void LCDTICK_nibble(LCDTICK* self, uint8_t rs, uint8_t nibble);
+uint16_t LCDTICK_ticks(LCDTICK* self, uint16_t us);
+/***Procedure & Function***/
+LCDTICK LCDTICKenable(volatile uint8_t *ddr, volatile uint8_t *port, uint16_t period)
+{
+	//LOCAL VARIABLES
+	uint8_t tSREG;
+	tSREG=SREG;
+	SREG&=~(1<<GLOBAL_INTERRUPT_ENABLE);
+	//ALLOCAÇÂO MEMORIA PARA Estrutura
+	LCDTICK lcd;
+	//import parametros
+	lcd.ddr=ddr;
+	lcd.port=port;
+	lcd.period=period ? period : ONE;
+	//inic variables
+	*lcd.ddr|=(1<<RS)|(1<<RW)|(1<<EN)|(1<<DB4)|(1<<DB5)|(1<<DB6)|(1<<DB7);
+	*lcd.port&=~((1<<RS)|(1<<RW)|(1<<EN)|(1<<DB4)|(1<<DB5)|(1<<DB6)|(1<<DB7));
+	lcd.head=ZERO;
+	lcd.tail=ZERO;
+	lcd.fb=NULL;
+	lcd.state=LCDTICK_POWERUP;
+	lcd.step=ZERO;
+	lcd.low=ZERO;
+	lcd.wexec=LCDTICK_ticks(&lcd, LCDTICK_EXEC_US);
+	lcd.wclear=LCDTICK_ticks(&lcd, LCDTICK_CLEAR_US);
+	lcd.wait=LCDTICK_ticks(&lcd, LCDTICK_POWERUP_US);
+	//Direccionar apontadores para PROTOTIPOS
+	lcd.tick=LCDTICK_tick;
+	lcd.command=LCDTICK_command;
+	lcd.putch=LCDTICK_putch;
+	lcd.string=LCDTICK_string;
+	lcd.gotoxy=LCDTICK_gotoxy;
+	lcd.clear=LCDTICK_clear;
+	lcd.attach=LCDTICK_attach;
+	lcd.space=LCDTICK_space;
+	lcd.idle=LCDTICK_idle;
+	/***queued after 4 bit switch***/
+	LCDTICK_push(&lcd, 0x28); // function set 4 bit 2 lines
+	LCDTICK_push(&lcd, 0x0C); // display on/off control
+	LCDTICK_push(&lcd, 0x01); // clear display
+	LCDTICK_push(&lcd, 0x06); // entry mode set
+	SREG=tSREG;
+	//
+	return lcd;
+}
+void LCDTICK_tick(LCDTICK* self)
+// Function to be used in the interrupt routine
+{
+	uint16_t code;
+	if(self->wait){
+		self->wait--;
+		return;
+	}
+	switch(self->state){
+		case LCDTICK_POWERUP:
+			self->step=ZERO;
+			self->state=LCDTICK_INIT;
+			break;
+		case LCDTICK_INIT:
+			LCDTICK_nibble(self, INST, LCDTICK_INIT_NIBBLE[self->step]);
+			self->wait=LCDTICK_ticks(self, LCDTICK_INIT_US[self->step]);
+			if(++self->step == sizeof(LCDTICK_INIT_NIBBLE))
+				self->state=LCDTICK_READY;
+			break;
+		case LCDTICK_READY:
+			if(self->low & LCDTICK_LOW_PENDING){
+				LCDTICK_nibble(self, (self->low & LCDTICK_LOW_RS) ? DATA : INST, self->low);
+				self->wait=(self->low & LCDTICK_LOW_SLOW) ? self->wclear : self->wexec;
+				self->low=ZERO;
+				break;
+			}
+			if(self->head != self->tail){
+				code=self->queue[self->tail];
+				self->tail=(self->tail+ONE) & LCDTICK_QUEUE_MASK;
+				if(self->fb)
+					self->fb->addr=LCDFB_UNKNOWN; // queue moved the address counter
+			}else if(self->fb){
+				code=self->fb->step(self->fb);
+				if(code == LCDFB_IDLE)
+					break;
+			}else
+				break;
+			LCDTICK_nibble(self, (code & LCDFB_DATA) ? DATA : INST, code>>4);
+			self->low=LCDTICK_LOW_PENDING | (code & 0x0F);
+			if(code & LCDFB_DATA)
+				self->low|=LCDTICK_LOW_RS;
+			else if((uint8_t)code < 0x04)
+				self->low|=LCDTICK_LOW_SLOW; // clear display, return home
+			break;
+		default:
+			break;
+	}
+}
+uint8_t LCDTICK_command(LCDTICK* self, uint8_t inst)
+{
+	return LCDTICK_push(self, inst);
+}
+uint8_t LCDTICK_putch(LCDTICK* self, char c)
+{
+	return LCDTICK_push(self, LCDFB_DATA | (uint8_t)c);
+}
+uint8_t LCDTICK_string(LCDTICK* self, const char* s)
+{
+	uint8_t count=ZERO;
+	while(*s){
+		if(!LCDTICK_push(self, LCDFB_DATA | (uint8_t)*s))
+			break;
+		s++;
+		count++;
+	}
+	return count;
+}
+uint8_t LCDTICK_gotoxy(LCDTICK* self, unsigned int y, unsigned int x)
+{
+	if(y > 3)
+		return ZERO;
+	if(x > LCDTICK_LINE-1)
+		x=LCDTICK_LINE-1; // stay inside the DDRAM line, never reach LCDFB_DATA
+	return LCDTICK_push(self, LCDTICK_ROW_ADDR[y]+x);
+}
+uint8_t LCDTICK_clear(LCDTICK* self)
+{
+	return LCDTICK_push(self, 0x01);
+}
+void LCDTICK_attach(LCDTICK* self, LCDFB* fb)
+{
+	if(fb)
+		fb->invalidate(fb);
+	self->fb=fb;
+}
+uint8_t LCDTICK_space(LCDTICK* self)
+{
+	return (self->tail-self->head-ONE) & LCDTICK_QUEUE_MASK;
+}
+uint8_t LCDTICK_idle(LCDTICK* self)
+{
+	if(self->head != self->tail || self->state != LCDTICK_READY || self->low || self->wait)
+		return ZERO;
+	if(self->fb)
+		if(self->fb->changed(self->fb))
+			return ZERO;
+	return ONE;
+}
+uint8_t LCDTICK_push(LCDTICK* self, uint16_t code)
+{
+	uint8_t next=(self->head+ONE) & LCDTICK_QUEUE_MASK;
+	if(next == self->tail)
+		return ZERO;
+	self->queue[self->head]=code;
+	self->head=next;
+	return ONE;
+}
+void LCDTICK_nibble(LCDTICK* self, uint8_t rs, uint8_t nibble)
+// data latched on falling edge of EN
+{
+	if(rs) *self->port|=(1<<RS); else *self->port&=~(1<<RS);
+	*self->port|=(1<<EN);
+	if(nibble & 0x08) *self->port|=1<<DB7; else *self->port&=~(1<<DB7);
+	if(nibble & 0x04) *self->port|=1<<DB6; else *self->port&=~(1<<DB6);
+	if(nibble & 0x02) *self->port|=1<<DB5; else *self->port&=~(1<<DB5);
+	if(nibble & 0x01) *self->port|=1<<DB4; else *self->port&=~(1<<DB4);
+	*self->port&=~(1<<EN);
+}
+uint16_t LCDTICK_ticks(LCDTICK* self, uint16_t us)
+// ticks to skip, the next tick is already one period away
+{
+	return (us+self->period-ONE)/self->period-ONE;
+}
+/***Interrupt***/
+/***EOF***/
@@ -0,0 +1,70 @@
+/************************************************************************
+	LCDTICK
+Author: Sergio Santos
+	<sergio.salazar.santos@gmail.com>
+License: GNU General Public License
+Hardware: all
+Date: 17102026
+Comment:
+	Non blocking HD44780 driver, one nibble per timer tick
+************************************************************************/
+#ifndef _LCDTICK_H_
+	#define _LCDTICK_H_
+/***Library***/
+#include <inttypes.h>
+#include "lcd.h"
+#include "lcdfb.h"
+/***Constant & Macro***/
+#ifndef LCDTICK_QUEUE_SIZE
+	#define LCDTICK_QUEUE_SIZE 32
+#endif
+#define LCDTICK_QUEUE_MASK (LCDTICK_QUEUE_SIZE - 1)
+#if (LCDTICK_QUEUE_SIZE & LCDTICK_QUEUE_MASK)
+	#error LCDTICK queue size is not a power of 2
+#endif
+/***state***/
+#define LCDTICK_POWERUP 0
+#define LCDTICK_INIT 1
+#define LCDTICK_READY 2
+/***Global Variable***/
+struct lcdtick{
+	volatile uint8_t* ddr;
+	volatile uint8_t* port;
+	uint16_t period; // tick period in us
+	volatile uint16_t queue[LCDTICK_QUEUE_SIZE]; // LCDFB_DATA|character or instruction
+	volatile uint8_t head;
+	volatile uint8_t tail;
+	LCDFB* fb; // drained when queue is empty
+	volatile uint8_t state;
+	uint8_t step; // init sequence position
+	uint8_t low; // low nibble still to send, bit 4 set when pending, bit 5 RS
+	uint16_t wait; // ticks to skip
+	uint16_t wexec; // ticks for normal instruction
+	uint16_t wclear; // ticks for clear and home
+	/******/
+	void (*tick)(struct lcdtick* self);
+	uint8_t (*command)(struct lcdtick* self, uint8_t inst);
+	uint8_t (*putch)(struct lcdtick* self, char c);
+	uint8_t (*string)(struct lcdtick* self, const char* s);
+	uint8_t (*gotoxy)(struct lcdtick* self, unsigned int y, unsigned int x);
+	uint8_t (*clear)(struct lcdtick* self);
+	void (*attach)(struct lcdtick* self, LCDFB* fb);
+	uint8_t (*space)(struct lcdtick* self);
+	uint8_t (*idle)(struct lcdtick* self);
+};
+typedef struct lcdtick LCDTICK;
+/***Header***/
+LCDTICK LCDTICKenable(volatile uint8_t *ddr, volatile uint8_t *port, uint16_t period);
+#endif
+/***Comment***
+Same pin assignment as lcd.h, RW is held low and the busy flag is never read, every wait is counted in
+ticks from the datasheet execution times. Call tick from a timer interrupt with period in us (40 to 1000,
+around 50us gives about 20000 characters per second), it sends at most one nibble and returns, nothing
+spins. Power up delay and the 4 bit init sequence also run from tick, the queue accepts entries from the
+start. command/putch/gotoxy/clear return 0 when the queue is full, string returns characters queued.
+When a framebuffer is attached tick takes the next changed cell whenever the queue is empty, draw on the
+framebuffer from main and the display follows without any flush call. idle tells when queue, framebuffer
+and LCD are all done. Sending clear through the queue under an attached framebuffer leaves them out of
+sync, use the framebuffer clear instead.
+*************/
+/***EOF***/
@@ -14,6 +14,7 @@ Comment:
 /***Library***/
 #include <avr/io.h>
 #include <util/delay.h>
+#include <avr/pgmspace.h>
 #include <inttypes.h>
 #include "mm74c923.h"
 #include "function.h"
@@ -22,6 +23,14 @@ Comment:
 	#define GLOBAL_INTERRUPT_ENABLE 7
 #endif
 #define MM74C923_KEY_BUFFER_SIZE 16
+// data pins to key code, LSB A to MSB extra, branch free
+#define MM74C923_GATHER(c) ( \
+	(((c)>>MM74C923_DATA_OUT_A) & 1) | \
+	((((c)>>MM74C923_DATA_OUT_B) & 1)<<1) | \
+	((((c)>>MM74C923_DATA_OUT_C) & 1)<<2) | \
+	((((c)>>MM74C923_DATA_OUT_D) & 1)<<3) | \
+	((((c)>>MM74C923_DATA_OUT_E) & 1)<<4) | \
+	((((c)>>MM74C923_EXTRA_DATA_OUT_PIN) & 1)<<5))
 /***Global File Variable***/
 FUNC func;
 volatile uint8_t *mm74c923_DDR;
@@ -29,12 +38,14 @@ volatile uint8_t *mm74c923_PIN;
 volatile uint8_t *mm74c923_PORT;
 uint8_t mm74c923_tmp;
 uint8_t mm74c923_mem;
-uint8_t MM74C923_KEY_CODE_INDEX;
-char MM74C923_KEY_CODE[]={
+const char MM74C923_KEY_TABLE[64] PROGMEM={
 	'A','B','C','E','G','H','I','J','M','N','O','P','Q','R','S','T','V','X','Y','Z',
 	'\0','\0','\0','\0','\0','\0','\0','\0','\0','\0','\0','\0','L','-','+','F','7','8','9','#',
-	'4','5','6','U','1','2','3','D','0','/','.','*','\0'
+	'4','5','6','U','1','2','3','D','0','/','.','*'
 };
+char mm74c923_queue[MM74C923_QUEUE_SIZE];
+volatile uint8_t mm74c923_head;
+volatile uint8_t mm74c923_tail;
 uint8_t MM74C923_KEY_BUFFER_INDEX;
 char MM74C923_KEY_BUFFER[MM74C923_KEY_BUFFER_SIZE];
 char MM74C923_KEY_BUFFER_EMPTY[]="";
@@ -45,6 +56,9 @@ char MM74C923_getch(void);
 char* MM74C923_gets(void);
 char* MM74C923_data(void);
 void MM74C923_data_clear(void);
+void MM74C923_capture(void);
+uint8_t MM74C923_available(void);
+char MM74C923_read(void);
 /***Procedure & Function***/
 MM74C923 MM74C923enable(volatile uint8_t *ddr, volatile uint8_t *pin, volatile uint8_t *port)
 {
@@ -71,6 +85,10 @@ MM74C923 MM74C923enable(volatile uint8_t *ddr, volatile uint8_t *pin, volatile u
 	mm74c923.gets=MM74C923_gets;
 	mm74c923.data=MM74C923_data;
 	mm74c923.data_clear=MM74C923_data_clear;
+	mm74c923.capture=MM74C923_capture;
+	mm74c923.available=MM74C923_available;
+	mm74c923.read=MM74C923_read;
+	mm74c923_head=mm74c923_tail=0;
 	SREG=tSREG;
 	//
 	return mm74c923;
@@ -88,18 +106,11 @@ char MM74C923_getch(void)
 	if(lh&(1<<MM74C923_DATA_AVAILABLE)){
 		*mm74c923_PORT&=~(1<<MM74C923_OUTPUT_ENABLE);
 		c=*mm74c923_PIN;
-		if(c&1<<MM74C923_DATA_OUT_A) MM74C923_KEY_CODE_INDEX|=1; else MM74C923_KEY_CODE_INDEX&=~1;
-		if(c&1<<MM74C923_DATA_OUT_B) MM74C923_KEY_CODE_INDEX|=2; else MM74C923_KEY_CODE_INDEX&=~2;
-		if(c&1<<MM74C923_DATA_OUT_C) MM74C923_KEY_CODE_INDEX|=4; else MM74C923_KEY_CODE_INDEX&=~4;
-		if(c&1<<MM74C923_DATA_OUT_D) MM74C923_KEY_CODE_INDEX|=8; else MM74C923_KEY_CODE_INDEX&=~8;
-		if(c&1<<MM74C923_DATA_OUT_E) MM74C923_KEY_CODE_INDEX|=16; else MM74C923_KEY_CODE_INDEX&=~16;
-		if(c&1<<MM74C923_EXTRA_DATA_OUT_PIN) MM74C923_KEY_CODE_INDEX|=32; else MM74C923_KEY_CODE_INDEX&=~32;
 	//}else if(hl&(1<<MM74C923_DATA_AVAILABLE)){
 		*mm74c923_PORT|=(1<<MM74C923_OUTPUT_ENABLE);
-		//MM74C923_KEY_CODE_INDEX=52;
-	}else
-		MM74C923_KEY_CODE_INDEX=52;
-	return MM74C923_KEY_CODE[MM74C923_KEY_CODE_INDEX];
+		return pgm_read_byte(&MM74C923_KEY_TABLE[MM74C923_GATHER(c)]);
+	}
+	return '\0';
 }
 char* MM74C923_gets(void)
 {
@@ -127,6 +138,33 @@ void MM74C923_data_clear(void){
 	MM74C923_KEY_BUFFER_INDEX=0;
 	MM74C923_KEY_BUFFER[MM74C923_KEY_BUFFER_INDEX]='\0';
 }
-
+void MM74C923_capture(void)
+// Function to be used in the interrupt routine of DATA_AVAILABLE
+{
+	uint8_t c, next;
+	*mm74c923_PORT&=~(1<<MM74C923_OUTPUT_ENABLE);
+	_delay_us(1); // output enable to data valid
+	c=*mm74c923_PIN;
+	*mm74c923_PORT|=(1<<MM74C923_OUTPUT_ENABLE);
+	c=pgm_read_byte(&MM74C923_KEY_TABLE[MM74C923_GATHER(c)]);
+	next=(mm74c923_head+1) & MM74C923_QUEUE_MASK;
+	if(c && next != mm74c923_tail){
+		mm74c923_queue[mm74c923_head]=c;
+		mm74c923_head=next;
+	}
+}
+uint8_t MM74C923_available(void)
+{
+	return (mm74c923_head-mm74c923_tail) & MM74C923_QUEUE_MASK;
+}
+char MM74C923_read(void)
+{
+	char c='\0';
+	if(mm74c923_head != mm74c923_tail){
+		c=mm74c923_queue[mm74c923_tail];
+		mm74c923_tail=(mm74c923_tail+1) & MM74C923_QUEUE_MASK;
+	}
+	return c;
+}
 /***Interrupt***/
 /***EOF***/
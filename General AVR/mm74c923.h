@@ -9,7 +9,9 @@ COMMENT:
 	  stable
 ************************************************************************/
 #ifndef _MM74C923_H_
-	#define _MM74C9232_H_
+	#define _MM74C923_H_
+/***Library***/
+#include <inttypes.h>
 /***Constant & Macro***/
 #define MM74C923_DATA_OUT_A 7 //ic pin 19 LSB
 #define MM74C923_DATA_OUT_B 6 //ic pin 18
@@ -19,6 +21,13 @@ COMMENT:
 #define MM74C923_EXTRA_DATA_OUT_PIN 2 // MSB
 #define MM74C923_OUTPUT_ENABLE 1 //ic pin 14
 #define MM74C923_DATA_AVAILABLE 0 //ic pin 13
+#ifndef MM74C923_QUEUE_SIZE
+	#define MM74C923_QUEUE_SIZE 16
+#endif
+#define MM74C923_QUEUE_MASK (MM74C923_QUEUE_SIZE - 1)
+#if (MM74C923_QUEUE_SIZE & MM74C923_QUEUE_MASK)
+	#error MM74C923 queue size is not a power of 2
+#endif
 /***Global Variable***/
 struct mm74c923{
 	void (*activate)(void);
@@ -26,9 +35,21 @@ struct mm74c923{
 	char* (*gets)(void);
 	char* (*data)(void);
 	void (*data_clear)(void);
+	/***interrupt mode***/
+	void (*capture)(void);
+	uint8_t (*available)(void);
+	char (*read)(void);
 };
 typedef struct mm74c923 MM74C923;
 /***Header***/
 MM74C923 MM74C923enable(volatile uint8_t *ddr, volatile uint8_t *pin, volatile uint8_t *port);
 #endif
+/***Comment***
+Interrupt mode: connect DATA_AVAILABLE to an external interrupt on the rising edge (on PORTD of the
+ATmega128 pin 0 already is INT0) and call capture from that interrupt routine. capture enables the
+outputs, gathers the 6 data bits with shifts and masks into the key code, looks the character up in a
+PROGMEM table and queues it, then the main loop takes keys with available and read. The chip holds the
+code until the next key so nothing is lost while the main loop is busy, up to MM74C923_QUEUE_SIZE-1 keys.
+Do not mix with activate/getch.
+*************/
 /***EOF***/
@@ -0,0 +1,145 @@
+/*************************************************************************
+	PIDBANK
+Author: Sergio Santos
+	<sergio.salazar.santos@gmail.com>
+License: GNU General Public License
+Hardware: all, one timer interrupt
+Date: 17102026
+Comment:
+	Bank of QPID loops stepped at fixed rates from a timer interrupt
+************************************************************************/
+/***Library***/
+#include <avr/io.h>
+#include <inttypes.h>
+#include "pidbank.h"
+/***Constant & Macro***/
+#ifndef GLOBAL_INTERRUPT_ENABLE
+	#define GLOBAL_INTERRUPT_ENABLE 7
+#endif
+#define ZERO 0
+#define ONE 1
+/***Global File Variable***/
+/***Header***/
+uint8_t PIDBANK_add(PIDBANK* self, QPID* pid, int16_t (*sensor)(void), void (*actuator)(int16_t OP), uint16_t period);
+void PIDBANK_tick_isr(PIDBANK* self);
+void PIDBANK_enable(PIDBANK* self, uint8_t index, uint8_t on);
+uint8_t PIDBANK_stat(PIDBANK* self, uint8_t index, struct pidloop* copy);
+void PIDBANK_clear(PIDBANK* self);
+/***Procedure & Function***/
+PIDBANK PIDBANKenable(uint16_t (*clock)(void), uint16_t tick)
+{
+	//ALLOCAÇÂO MEMORIA PARA Estrutura
+	PIDBANK pidbank;
+	//import parametros
+	pidbank.clock=clock;
+	pidbank.tick=tick;
+	//inic variables
+	pidbank.nloop=ZERO;
+	pidbank.busy=ZERO;
+	pidbank.overrun=ZERO;
+	//Direccionar apontadores para PROTOTIPOS
+	pidbank.add=PIDBANK_add;
+	pidbank.tick_isr=PIDBANK_tick_isr;
+	pidbank.enable=PIDBANK_enable;
+	pidbank.stat=PIDBANK_stat;
+	pidbank.clear=PIDBANK_clear;
+	//
+	return pidbank;
+}
+uint8_t PIDBANK_add(PIDBANK* self, QPID* pid, int16_t (*sensor)(void), void (*actuator)(int16_t OP), uint16_t period)
+{
+	uint8_t tSREG;
+	struct pidloop* loop;
+	uint8_t index=PIDBANK_NONE;
+	tSREG=SREG;
+	SREG&=~(1<<GLOBAL_INTERRUPT_ENABLE);
+	if(self->nloop < PIDBANK_MAX && pid && period){
+		index=self->nloop++;
+		loop=&self->loop[index];
+		loop->pid=pid;
+		loop->sensor=sensor;
+		loop->actuator=actuator;
+		loop->period=period;
+		loop->count=ONE+(index % period); // spread start
+		loop->run=ONE;
+		loop->exec=ZERO;
+		loop->worst=ZERO;
+		loop->missed=ZERO;
+		loop->steps=ZERO;
+	}
+	SREG=tSREG;
+	return index;
+}
+void PIDBANK_tick_isr(PIDBANK* self)
+// Function to be used in the interrupt routine
+{
+	struct pidloop* loop;
+	uint16_t start, begin, end;
+	uint8_t i;
+	int16_t OP;
+	if(self->busy){
+		self->overrun++; // nested, previous tick still running
+		return;
+	}
+	self->busy=ONE;
+	start=self->clock ? self->clock() : ZERO;
+	for(i=ZERO;i<self->nloop;i++){
+		loop=&self->loop[i];
+		if(!loop->run || --loop->count)
+			continue;
+		loop->count=loop->period;
+		begin=self->clock ? self->clock() : ZERO;
+		OP=loop->pid->output(loop->pid, loop->sensor ? loop->sensor() : loop->pid->PV);
+		if(loop->actuator)
+			loop->actuator(OP);
+		end=self->clock ? self->clock() : ZERO;
+		loop->exec=end-begin;
+		if(loop->exec > loop->worst)
+			loop->worst=loop->exec;
+		if((uint32_t)(uint16_t)(end-start) > (uint32_t)loop->period*self->tick)
+			loop->missed++;
+		loop->steps++;
+	}
+	if(self->clock && (uint16_t)(self->clock()-start) > self->tick)
+		self->overrun++;
+	self->busy=ZERO;
+}
+void PIDBANK_enable(PIDBANK* self, uint8_t index, uint8_t on)
+{
+	uint8_t tSREG;
+	if(index >= self->nloop)
+		return;
+	tSREG=SREG;
+	SREG&=~(1<<GLOBAL_INTERRUPT_ENABLE);
+	self->loop[index].run=on;
+	self->loop[index].count=self->loop[index].period;
+	SREG=tSREG;
+}
+uint8_t PIDBANK_stat(PIDBANK* self, uint8_t index, struct pidloop* copy)
+{
+	uint8_t tSREG;
+	if(index >= self->nloop)
+		return ZERO;
+	tSREG=SREG;
+	SREG&=~(1<<GLOBAL_INTERRUPT_ENABLE);
+	*copy=self->loop[index];
+	SREG=tSREG;
+	return ONE;
+}
+void PIDBANK_clear(PIDBANK* self)
+{
+	uint8_t tSREG;
+	uint8_t i;
+	tSREG=SREG;
+	SREG&=~(1<<GLOBAL_INTERRUPT_ENABLE);
+	for(i=ZERO;i<self->nloop;i++){
+		self->loop[i].exec=ZERO;
+		self->loop[i].worst=ZERO;
+		self->loop[i].missed=ZERO;
+		self->loop[i].steps=ZERO;
+	}
+	self->overrun=ZERO;
+	SREG=tSREG;
+}
+/***Interrupt***/
+/***EOF***/
@@ -0,0 +1,142 @@
+/*************************************************************************
+	PLANTSIM
+Author: Sergio Santos
+	<sergio.salazar.santos@gmail.com>
+License: GNU General Public License
+Hardware: none, runs on the PC or the mcu
+Date: 17102026
+Comment:
+	Plant models and closed loop benchmark for control code
+************************************************************************/
+/***Library***/
+#include <inttypes.h>
+#include "plantsim.h"
+/***Constant & Macro***/
+#define ZERO 0
+#define ONE 1
+#define PLANTSIM_CALIBRATE 256 // empty control calls timed by bench
+/***Global File Variable***/
+/***Header***/
+void PLANTSIM_reset(PLANTSIM* self, float y);
+float PLANTSIM_step(PLANTSIM* self, float u);
+void PLANTSIM_bench(PLANTSIM* self, float (*control)(void* ctx, float SP, float PV, float dt), void* ctx, float SP, uint32_t steps, float band, uint32_t (*clock)(void), struct plantbench* result);
+float PLANTSIM_null(void* ctx, float SP, float PV, float dt);
+/***Procedure & Function***/
+PLANTSIM PLANTSIMenable(uint8_t model, float gain, float tau, float deadtime, float dt)
+{
+	//ALLOCAÇÂO MEMORIA PARA Estrutura
+	PLANTSIM plantsim;
+	float n;
+	//import parametros
+	plantsim.model=model;
+	plantsim.gain=gain;
+	plantsim.tau=(tau > dt) ? tau : dt;
+	plantsim.dt=dt;
+	//inic variables
+	n=(dt > ZERO) ? deadtime/dt+0.5f : ZERO;
+	plantsim.clipped=ZERO;
+	if(n > PLANTSIM_DELAY_MAX){
+		n=PLANTSIM_DELAY_MAX;
+		plantsim.clipped=ONE;
+	}
+	plantsim.ndelay=(uint16_t)n;
+	plantsim.ambient=ZERO;
+	//Direccionar apontadores para PROTOTIPOS
+	plantsim.reset=PLANTSIM_reset;
+	plantsim.step=PLANTSIM_step;
+	plantsim.bench=PLANTSIM_bench;
+	PLANTSIM_reset(&plantsim, ZERO);
+	//
+	return plantsim;
+}
+void PLANTSIM_reset(PLANTSIM* self, float y)
+{
+	uint16_t i;
+	if(self->model == PLANTSIM_THERMAL)
+		self->ambient=y;
+	self->y=y;
+	self->x=y;
+	self->index=ZERO;
+	for(i=ZERO;i<self->ndelay;i++)
+		self->delay[i]=ZERO;
+}
+float PLANTSIM_step(PLANTSIM* self, float u)
+{
+	float ud=u;
+	if(self->ndelay){
+		ud=self->delay[self->index];
+		self->delay[self->index]=u;
+		if(++self->index == self->ndelay)
+			self->index=ZERO;
+	}
+	switch(self->model){
+		case PLANTSIM_INTEGRATING:
+			self->y+=self->gain*ud*self->dt;
+			break;
+		case PLANTSIM_THERMAL:
+			if(ud < ZERO)
+				ud=ZERO; // heater only
+			self->x+=(self->ambient+self->gain*ud-self->x)*self->dt*4/self->tau;
+			self->y+=(self->x-self->y)*self->dt/self->tau;
+			break;
+		default:
+			self->y+=(self->gain*ud-self->y)*self->dt/self->tau;
+			break;
+	}
+	return self->y;
+}
+void PLANTSIM_bench(PLANTSIM* self, float (*control)(void* ctx, float SP, float PV, float dt), void* ctx, float SP, uint32_t steps, float band, uint32_t (*clock)(void), struct plantbench* result)
+{
+	float y0=self->ambient;
+	float span, err, peak;
+	uint32_t k, start, stop, zero=ZERO, outside=ZERO;
+	uint64_t sum=ZERO;
+	float u;
+	PLANTSIM_reset(self, y0);
+	span=SP-y0;
+	if(span < ZERO)
+		span=-span;
+	peak=y0;
+	result->iae=ZERO;
+	result->cost=ZERO;
+	/***cost of the clock reads and the call alone, mean over an empty control***/
+	if(clock){
+		for(k=ZERO;k<PLANTSIM_CALIBRATE;k++){
+			start=clock();
+			PLANTSIM_null(ctx, SP, y0, self->dt);
+			sum+=clock()-start;
+		}
+		zero=(uint32_t)(sum/PLANTSIM_CALIBRATE);
+	}
+	for(k=ZERO;k<steps;k++){
+		start=clock ? clock() : ZERO;
+		u=control(ctx, SP, self->y, self->dt);
+		if(clock){
+			stop=clock()-start;
+			result->cost+=(stop > zero) ? stop-zero : ZERO;
+		}
+		PLANTSIM_step(self, u);
+		err=SP-self->y;
+		if(err < ZERO)
+			err=-err;
+		result->iae+=err*self->dt;
+		if(err > band*span)
+			outside=k+ONE;
+		if((SP >= y0) ? (self->y > peak) : (self->y < peak))
+			peak=self->y;
+	}
+	result->steps=steps;
+	result->settling=outside*self->dt;
+	result->overshoot=(span > ZERO) ? ((SP >= y0) ? peak-SP : SP-peak)*100/span : ZERO;
+	if(result->overshoot < ZERO)
+		result->overshoot=ZERO;
+	result->cost_step=steps ? (float)result->cost/steps : ZERO;
+}
+float PLANTSIM_null(void* ctx, float SP, float PV, float dt)
+// baseline for bench, called through a pointer like control
+{
+	(void)ctx; (void)SP; (void)PV; (void)dt;
+	return ZERO;
+}
+/***Interrupt***/
+/***EOF***/
@@ -0,0 +1,70 @@
+/************************************************************************
+	PLANTSIM
+Author: Sergio Santos
+	<sergio.salazar.santos@gmail.com>
+License: GNU General Public License
+Hardware: none, runs on the PC or the mcu
+Date: 17102026
+Comment:
+	Plant models and closed loop benchmark for control code
+************************************************************************/
+#ifndef _PLANTSIM_H_
+	#define _PLANTSIM_H_
+/***Library***/
+#include <inttypes.h>
+/***Constant & Macro***/
+#ifndef PLANTSIM_DELAY_MAX
+	#ifdef __AVR__
+		#define PLANTSIM_DELAY_MAX 256 // dead time samples
+	#else
+		#define PLANTSIM_DELAY_MAX 8192 // PC, 81.92s at dt 10ms
+	#endif
+#endif
+/***model***/
+#define PLANTSIM_FOPDT 0 // first order plus dead time
+#define PLANTSIM_INTEGRATING 1 // gain*u integrated, plus dead time
+#define PLANTSIM_THERMAL 2 // heater and body lags, heating only, ambient
+/***Global Variable***/
+struct plantbench{
+	float iae; // integral of absolute error
+	float overshoot; // percent of step
+	float settling; // seconds until error stays inside band
+	uint32_t steps;
+	uint64_t cost; // clock counts spent in control, clock reads taken out
+	float cost_step; // clock counts per control step
+};
+struct plantsim{
+	uint8_t model;
+	float gain;
+	float tau; // seconds
+	float dt; // seconds
+	float ambient; // output at rest, thermal
+	float y; // output
+	float x; // internal state, thermal heater
+	float delay[PLANTSIM_DELAY_MAX];
+	uint16_t ndelay;
+	uint16_t index;
+	uint8_t clipped; // deadtime longer than PLANTSIM_DELAY_MAX samples
+	/******/
+	void (*reset)(struct plantsim* self, float y);
+	float (*step)(struct plantsim* self, float u);
+	void (*bench)(struct plantsim* self, float (*control)(void* ctx, float SP, float PV, float dt), void* ctx, float SP, uint32_t steps, float band, uint32_t (*clock)(void), struct plantbench* result);
+};
+typedef struct plantsim PLANTSIM;
+/***Header***/
+PLANTSIM PLANTSIMenable(uint8_t model, float gain, float tau, float deadtime, float dt);
+#endif
+/***Comment***
+step advances the model by dt with input u and returns the output. FOPDT is y'=(gain*u-y)/tau,
+INTEGRATING is y'=gain*u, THERMAL is two lags in series, heater x'=(ambient+gain*u-x)/(tau/4) and body
+y'=(x-y)/tau, with u below zero taken as zero. deadtime delays u by deadtime/dt samples, up to
+PLANTSIM_DELAY_MAX (256 on the AVR, 8192 on the PC), a longer deadtime is cut to the limit and sets
+clipped, check it before trusting a bench. bench resets the plant, runs steps closed loop steps from rest to SP calling control
+(ctx, SP, PV, dt) and fills result: IAE, overshoot in percent of the step, settling time to stay inside
+band (fraction of the step, 0.02 is 2%), and when clock is given the counts spent inside control,
+clock may wrap, only the difference around each control call is summed, less the mean cost of the clock
+reads and call around PLANTSIM_null (PLANTSIM_CALIBRATE calls) so a control that does nothing costs about 0.
+Only float and no registers are used, so the same file builds for the PC to check controller and filter
+changes against a fixed plant, host/plantbench.c runs ZNPID and QPID on the three models.
+*************/
+/***EOF***/
@@ -0,0 +1,167 @@
+/*************************************************************************
+	QPID
+Author: Sergio Santos
+	<sergio.salazar.santos@gmail.com>
+License: GNU General Public License
+Hardware: all
+Date: 17102026
+Comment:
+	Fixed point PID, Q16 gains, saturating arithmetic, no float
+************************************************************************/
+/***Library***/
+#include <inttypes.h>
+#include "qpid.h"
+/***Constant & Macro***/
+#define ZERO 0
+#define ONE 1
+#define QPID_MAX32 2147483647L
+#define QPID_MIN32 (-QPID_MAX32) // symmetric, negation can not wrap
+/***Global File Variable***/
+/***Header***/
+void QPID_set_kc(QPID* self, int32_t kc);
+void QPID_set_ki(QPID* self, int32_t ki);
+void QPID_set_kd(QPID* self, int32_t kd);
+void QPID_set_SP(QPID* self, int16_t setpoint);
+void QPID_set_limit(QPID* self, int16_t min, int16_t max);
+int16_t QPID_delta(int16_t present_value, int16_t past_value);
+int32_t QPID_sum(int32_t value_1, int32_t value_2);
+int32_t QPID_product(int16_t value, int32_t gain);
+int16_t QPID_output(QPID* self, int16_t PV);
+/***Procedure & Function***/
+QPID QPIDenable(uint16_t dt)
+{
+	//ALLOCAÇÂO MEMORIA PARA Estrutura
+	QPID qpid;
+	//import parametros
+	qpid.dt=dt ? dt : ONE;
+	//inic variables
+	qpid.kc=QPID_ONE;
+	qpid.ki=ZERO;
+	qpid.kd=ZERO;
+	qpid.integral=ZERO;
+	qpid.fraction=ZERO;
+	qpid.PV_past=ZERO;
+	qpid.first=ONE;
+	qpid.SetPoint=ZERO;
+	qpid.PV=ZERO;
+	qpid.OP=ZERO;
+	qpid.outMAX=QPID_outMAX;
+	qpid.outMIN=QPID_outMIN;
+	//Direccionar apontadores para PROTOTIPOS
+	qpid.set_kc=QPID_set_kc;
+	qpid.set_ki=QPID_set_ki;
+	qpid.set_kd=QPID_set_kd;
+	qpid.set_SP=QPID_set_SP;
+	qpid.set_limit=QPID_set_limit;
+	qpid.output=QPID_output;
+	//
+	return qpid;
+}
+void QPID_set_kc(QPID* self, int32_t kc)
+{
+	self->kc=kc;
+}
+void QPID_set_ki(QPID* self, int32_t ki)
+// ki per second to per step
+{
+	int64_t k=((int64_t)ki*self->dt*256)/1000; // Q24, 8 bits below Q16 so small gains keep their value
+	self->ki=(k > QPID_MAX32) ? QPID_MAX32 : (k < QPID_MIN32) ? QPID_MIN32 : (int32_t)k;
+}
+void QPID_set_kd(QPID* self, int32_t kd)
+// kd in seconds to per step
+{
+	int64_t k=((int64_t)kd*1000)/self->dt;
+	self->kd=(k > QPID_MAX32) ? QPID_MAX32 : (k < QPID_MIN32) ? QPID_MIN32 : (int32_t)k;
+}
+void QPID_set_SP(QPID* self, int16_t setpoint)
+{
+	self->SetPoint=setpoint;
+}
+void QPID_set_limit(QPID* self, int16_t min, int16_t max)
+{
+	self->outMIN=min;
+	self->outMAX=max;
+	self->integral=ZERO;
+}
+int16_t QPID_delta(int16_t present_value, int16_t past_value)
+// saturating difference
+{
+	int32_t d=(int32_t)present_value-past_value;
+	if(d > 32767)
+		return 32767;
+	if(d < -32768)
+		return -32768;
+	return (int16_t)d;
+}
+int32_t QPID_sum(int32_t value_1, int32_t value_2)
+// saturating sum
+{
+	int32_t s=(int32_t)((uint32_t)value_1+(uint32_t)value_2);
+	if(value_1 >= ZERO && value_2 >= ZERO && s < ZERO)
+		return QPID_MAX32;
+	if(value_1 < ZERO && value_2 < ZERO && s >= ZERO)
+		return QPID_MIN32;
+	if(s < QPID_MIN32)
+		return QPID_MIN32;
+	return s;
+}
+int32_t QPID_product(int16_t value, int32_t gain)
+// value times Q16 gain, result Q16 saturated
+{
+	int32_t hi=(int32_t)value*(int16_t)(gain>>16);
+	if(hi > 32767)
+		return QPID_MAX32;
+	if(hi < -32768)
+		return QPID_MIN32;
+	return QPID_sum(hi<<16, (int32_t)value*(int32_t)(uint16_t)gain);
+}
+int16_t QPID_output(QPID* self, int16_t PV)
+{
+	int32_t max=(int32_t)self->outMAX<<16;
+	int32_t min=(int32_t)self->outMIN<<16;
+	int32_t pd, integral, result, fraction;
+	int16_t err=QPID_delta(self->SetPoint, PV);
+	self->PV=PV;
+	if(self->first){
+		self->PV_past=PV;
+		self->first=ZERO;
+	}
+	/***proportional and derivative on measurement***/
+	pd=QPID_sum(QPID_product(err, self->kc), -QPID_product(QPID_delta(PV, self->PV_past), self->kd));
+	self->PV_past=PV;
+	/***integral clamped to output range***/
+	// Q16 part of ki by the split product, the low 8 bits of Q24 carried in fraction
+	fraction=(int32_t)err*(self->ki & 0xFF)+self->fraction;
+	integral=QPID_sum(self->integral, QPID_sum(QPID_product(err, self->ki>>8), fraction>>8));
+	fraction&=0xFF;
+	if(integral > max)
+		integral=max;
+	else if(integral < min)
+		integral=min;
+	result=QPID_sum(pd, integral);
+	/***anti windup, hold integral while saturated the same way***/
+	if(result > max){
+		if(integral < self->integral){
+			self->integral=integral;
+			self->fraction=fraction;
+		}
+		result=max;
+	}else if(result < min){
+		if(integral > self->integral){
+			self->integral=integral;
+			self->fraction=fraction;
+		}
+		result=min;
+	}else{
+		self->integral=integral;
+		self->fraction=fraction;
+	}
+	self->OP=(int16_t)((result+0x8000L)>>16);
+	return self->OP;
+}
+/***Interrupt***/
+/****comment:
+Returned OP is rounded to the integer unit, offset and scale it to the actuator range or give the
+actuator range directly with set_limit.
+*************/
+/***EOF***/
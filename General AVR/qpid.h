@@ -0,0 +1,60 @@
+/************************************************************************
+	QPID
+Author: Sergio Santos
+	<sergio.salazar.santos@gmail.com>
+License: GNU General Public License
+Hardware: all
+Date: 17102026
+Comment:
+	Fixed point PID, Q16 gains, saturating arithmetic, no float
+************************************************************************/
+#ifndef _QPID_H_
+	#define _QPID_H_
+/***Library***/
+#include <inttypes.h>
+/***Constant & Macro***/
+#define QPID_ONE 65536L // 1.0 in Q16
+#define QPID_outMAX 1023
+#define QPID_outMIN -1023
+/***Global Variable***/
+struct qpid{
+	int32_t kc; // constant p, Q16
+	int32_t ki; // constant i per step, Q24 (ki*dt)
+	int32_t kd; // constant d per step, Q16 (kd/dt)
+	uint16_t dt; // step in ms
+	int32_t integral; // Q16 output units
+	int32_t fraction; // integral below Q16, 2^-24 units
+	int16_t PV_past; // derivative on measurement
+	uint8_t first; // PV_past taken from the first PV
+	int16_t SetPoint; // desired output
+	int16_t PV; // output feedback
+	int16_t OP; // output signal
+	int16_t outMAX;
+	int16_t outMIN;
+	/******/
+	void (*set_kc)(struct qpid* self, int32_t kc);
+	void (*set_ki)(struct qpid* self, int32_t ki);
+	void (*set_kd)(struct qpid* self, int32_t kd);
+	void (*set_SP)(struct qpid* self, int16_t setpoint);
+	void (*set_limit)(struct qpid* self, int16_t min, int16_t max);
+	int16_t (*output)(struct qpid* self, int16_t PV);
+};
+typedef struct qpid QPID;
+/***Header***/
+QPID QPIDenable(uint16_t dt);
+#endif
+/***EOF***/
+/***COMMENT***
+Integer version of ZNPID for a fixed step dt in ms (constant rate, timer driven). Gains are Q16 in the
+same units as ZNPID, kc 1.5 is 98304, ki per second, kd in seconds, set_ki and set_kd fold dt into the
+stored value so output has no division. ki per step is kept in Q24 and the integral carries the bits
+below Q16 from step to step, ki 0.01/s at 10ms is 1677/2^24 (0.03% off) instead of 6/2^16 (8% off) and
+gains down to about 1e-5/s still integrate, ki per step is limited to 127. Every product is 16x32 bit split in two 32 bit multiplies and
+every sum saturates at the int32 limits, nothing can wrap. Derivative is on PV, not on the error, so a
+set point step gives no kick. Anti windup: the integral is kept inside the output limits and does not
+grow while the output is saturated in the same direction as the error.
+Estimated cost at 16MHz with avr-gcc -Os, counted by hand from the libgcc routines and not measured on
+the part: seven __mulsi3 calls of about 40 cycles and about 270 cycles of saturating adds and compares,
+some 550 cycles (35us) per output, against about 2500 cycles (150us) for ZNPID output with avr-libc
+float. The first output seeds PV_past with its PV so a PV far from 0 gives no derivative kick.
+*************/
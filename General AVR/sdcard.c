@@ -0,0 +1,350 @@
+/*************************************************************************
+	SDCARD
+Author: Sergio Santos
+	<sergio.salazar.santos@gmail.com>
+License: GNU General Public License
+Hardware: SD/MMC card in SPI mode
+Date: 17102026
+Comment:
+	Block driver on top of SPI vtable
+************************************************************************/
+/***Library***/
+#include <inttypes.h>
+#include "sdcard.h"
+/***Constant & Macro***/
+#define ZERO 0
+#define ONE 1
+#define SDCARD_DUMMY 0xFF
+#define SDCARD_CHUNK 128 // SPI vtable length is uint8_t
+/***commands***/
+#define CMD0 0 // GO_IDLE_STATE
+#define CMD1 1 // SEND_OP_COND (MMC)
+#define CMD8 8 // SEND_IF_COND
+#define CMD12 12 // STOP_TRANSMISSION
+#define CMD16 16 // SET_BLOCKLEN
+#define CMD17 17 // READ_SINGLE_BLOCK
+#define CMD18 18 // READ_MULTIPLE_BLOCK
+#define CMD24 24 // WRITE_BLOCK
+#define CMD25 25 // WRITE_MULTIPLE_BLOCK
+#define CMD55 55 // APP_CMD
+#define CMD58 58 // READ_OCR
+#define ACMD23 (0x80 | 23) // SET_WR_BLK_ERASE_COUNT
+#define ACMD41 (0x80 | 41) // SD_SEND_OP_COND
+/***R1 and tokens***/
+#define R1_IDLE 0x01
+#define R1_ILLEGAL 0x04
+#define TOKEN_START_BLOCK 0xFE
+#define TOKEN_START_MULTI 0xFC
+#define TOKEN_STOP_MULTI 0xFD
+#define DATA_RESPONSE_MASK 0x1F
+#define DATA_ACCEPTED 0x05
+/***retries***/
+#define SDCARD_CMD_RETRY 10
+#define SDCARD_INIT_RETRY 20000
+#define SDCARD_TOKEN_RETRY 50000UL
+#define SDCARD_BUSY_RETRY 500000UL
+/***Global File Variable***/
+uint8_t sdcard_dummy[SDCARD_CHUNK];
+/***Header***/
+uint8_t SDCARD_init(SDCARD* self);
+uint8_t SDCARD_read_block(SDCARD* self, uint32_t lba, uint8_t* buffer);
+uint8_t SDCARD_read_multi(SDCARD* self, uint32_t lba, uint8_t* buffer, uint16_t n);
+uint8_t SDCARD_write_block(SDCARD* self, uint32_t lba, const uint8_t* buffer);
+uint8_t SDCARD_write_multi(SDCARD* self, uint32_t lba, const uint8_t* buffer, uint16_t n);
+uint8_t SDCARD_stream_start(SDCARD* self, uint32_t lba, uint32_t count);
+uint8_t SDCARD_stream_write(SDCARD* self, const uint8_t* buffer);
+uint8_t SDCARD_stream_stop(SDCARD* self);
+uint8_t SDCARD_wait_ready(SDCARD* self);
+uint8_t SDCARD_command(SDCARD* self, uint8_t cmd, uint32_t arg);
+uint8_t SDCARD_receive(SDCARD* self, uint8_t* buffer);
+uint8_t SDCARD_send(SDCARD* self, uint8_t token, const uint8_t* buffer);
+void SDCARD_select(SDCARD* self);
+void SDCARD_release(SDCARD* self);
+uint32_t SDCARD_address(SDCARD* self, uint32_t lba);
+/***Procedure & Function***/
+SDCARD SDCARDenable(SPI* spi, void (*chipselect)(uint8_t select))
+{
+	//ALLOCAÇÂO MEMORIA PARA Estrutura
+	SDCARD sdcard;
+	uint8_t i;
+	//import parametros
+	sdcard.spi=spi;
+	sdcard.chipselect=chipselect;
+	//inic variables
+	sdcard.type=SDCARD_TYPE_NONE;
+	sdcard.streaming=ZERO;
+	for(i=ZERO;i<SDCARD_CHUNK;i++)
+		sdcard_dummy[i]=SDCARD_DUMMY;
+	//Direccionar apontadores para PROTOTIPOS
+	sdcard.init=SDCARD_init;
+	sdcard.read_block=SDCARD_read_block;
+	sdcard.read_multi=SDCARD_read_multi;
+	sdcard.write_block=SDCARD_write_block;
+	sdcard.write_multi=SDCARD_write_multi;
+	sdcard.stream_start=SDCARD_stream_start;
+	sdcard.stream_write=SDCARD_stream_write;
+	sdcard.stream_stop=SDCARD_stream_stop;
+	//
+	return sdcard;
+}
+uint8_t SDCARD_init(SDCARD* self)
+{
+	uint16_t i;
+	uint8_t r1;
+	uint8_t ocr[4];
+	uint32_t arg=ZERO;
+	self->type=SDCARD_TYPE_NONE;
+	self->streaming=ZERO;
+	/***at least 74 clocks with CS high***/
+	SDCARD_release(self);
+	self->spi->transmit_sync(sdcard_dummy, 10);
+	/***software reset***/
+	SDCARD_select(self);
+	for(i=ZERO; SDCARD_command(self, CMD0, 0) != R1_IDLE; i++){
+		if(i > SDCARD_CMD_RETRY){
+			SDCARD_release(self);
+			return SDCARD_ERROR_INIT;
+		}
+	}
+	/***version 2 cards answer interface condition***/
+	r1=SDCARD_command(self, CMD8, 0x1AA);
+	if(!(r1 & R1_ILLEGAL)){
+		self->spi->transfer_sync(sdcard_dummy, ocr, 4);
+		if(ocr[3] != 0xAA){
+			SDCARD_release(self);
+			return SDCARD_ERROR_INIT;
+		}
+		self->type=SDCARD_TYPE_SD2;
+		arg=0x40000000UL; // host supports high capacity
+	}else
+		self->type=SDCARD_TYPE_SD1;
+	/***leave idle state***/
+	for(i=ZERO; (r1=SDCARD_command(self, ACMD41, arg)) != ZERO; i++){
+		if(r1 & R1_ILLEGAL){
+			/***not SD, try MMC***/
+			self->type=SDCARD_TYPE_MMC;
+			for(i=ZERO; SDCARD_command(self, CMD1, 0) != ZERO; i++){
+				if(i > SDCARD_INIT_RETRY){
+					SDCARD_release(self);
+					return SDCARD_ERROR_INIT;
+				}
+			}
+			break;
+		}
+		if(i > SDCARD_INIT_RETRY){
+			SDCARD_release(self);
+			return SDCARD_ERROR_INIT;
+		}
+	}
+	/***block or byte addressing***/
+	if(self->type == SDCARD_TYPE_SD2){
+		if(SDCARD_command(self, CMD58, 0) != ZERO){
+			SDCARD_release(self);
+			return SDCARD_ERROR_CMD;
+		}
+		self->spi->transfer_sync(sdcard_dummy, ocr, 4);
+		if(ocr[0] & 0x40)
+			self->type=SDCARD_TYPE_SDHC;
+	}
+	if(self->type != SDCARD_TYPE_SDHC){
+		if(SDCARD_command(self, CMD16, SDCARD_BLOCK_SIZE) != ZERO){
+			SDCARD_release(self);
+			return SDCARD_ERROR_CMD;
+		}
+	}
+	SDCARD_release(self);
+	return SDCARD_OK;
+}
+uint8_t SDCARD_read_block(SDCARD* self, uint32_t lba, uint8_t* buffer)
+{
+	uint8_t ret=SDCARD_OK;
+	SDCARD_select(self);
+	if(SDCARD_command(self, CMD17, SDCARD_address(self, lba)) != ZERO)
+		ret=SDCARD_ERROR_CMD;
+	else
+		ret=SDCARD_receive(self, buffer);
+	SDCARD_release(self);
+	return ret;
+}
+uint8_t SDCARD_read_multi(SDCARD* self, uint32_t lba, uint8_t* buffer, uint16_t n)
+{
+	uint8_t ret=SDCARD_OK;
+	SDCARD_select(self);
+	if(SDCARD_command(self, CMD18, SDCARD_address(self, lba)) != ZERO)
+		ret=SDCARD_ERROR_CMD;
+	else{
+		for(; n && ret == SDCARD_OK; n--, buffer+=SDCARD_BLOCK_SIZE)
+			ret=SDCARD_receive(self, buffer);
+		SDCARD_command(self, CMD12, 0);
+		if(!SDCARD_wait_ready(self) && ret == SDCARD_OK)
+			ret=SDCARD_ERROR_TIMEOUT;
+	}
+	SDCARD_release(self);
+	return ret;
+}
+uint8_t SDCARD_write_block(SDCARD* self, uint32_t lba, const uint8_t* buffer)
+{
+	uint8_t ret=SDCARD_OK;
+	SDCARD_select(self);
+	if(SDCARD_command(self, CMD24, SDCARD_address(self, lba)) != ZERO)
+		ret=SDCARD_ERROR_CMD;
+	else{
+		ret=SDCARD_send(self, TOKEN_START_BLOCK, buffer);
+		if(!SDCARD_wait_ready(self) && ret == SDCARD_OK)
+			ret=SDCARD_ERROR_TIMEOUT;
+	}
+	SDCARD_release(self);
+	return ret;
+}
+uint8_t SDCARD_write_multi(SDCARD* self, uint32_t lba, const uint8_t* buffer, uint16_t n)
+{
+	uint8_t ret;
+	ret=SDCARD_stream_start(self, lba, n);
+	for(; n && ret == SDCARD_OK; n--, buffer+=SDCARD_BLOCK_SIZE)
+		ret=SDCARD_stream_write(self, buffer);
+	if(self->streaming){
+		if(SDCARD_stream_stop(self) != SDCARD_OK && ret == SDCARD_OK)
+			ret=SDCARD_ERROR_WRITE;
+	}
+	return ret;
+}
+uint8_t SDCARD_stream_start(SDCARD* self, uint32_t lba, uint32_t count)
+{
+	SDCARD_select(self);
+	if(count && self->type != SDCARD_TYPE_MMC)
+		SDCARD_command(self, ACMD23, count & 0x007FFFFFUL); // pre-erase hint, failure is harmless
+	if(SDCARD_command(self, CMD25, SDCARD_address(self, lba)) != ZERO){
+		SDCARD_release(self);
+		return SDCARD_ERROR_CMD;
+	}
+	self->streaming=ONE;
+	return SDCARD_OK;
+}
+uint8_t SDCARD_stream_write(SDCARD* self, const uint8_t* buffer)
+{
+	uint8_t ret;
+	if(!self->streaming)
+		return SDCARD_ERROR_CMD;
+	/***card is busy programming the previous block***/
+	if(!SDCARD_wait_ready(self))
+		return SDCARD_ERROR_TIMEOUT;
+	ret=SDCARD_send(self, TOKEN_START_MULTI, buffer);
+	if(ret != SDCARD_OK)
+		SDCARD_stream_stop(self);
+	return ret;
+}
+uint8_t SDCARD_stream_stop(SDCARD* self)
+{
+	uint8_t ret=SDCARD_OK;
+	if(!self->streaming)
+		return ret;
+	if(!SDCARD_wait_ready(self))
+		ret=SDCARD_ERROR_TIMEOUT;
+	self->spi->fast_shift(TOKEN_STOP_MULTI);
+	self->spi->fast_shift(SDCARD_DUMMY); // Nbr
+	if(!SDCARD_wait_ready(self))
+		ret=SDCARD_ERROR_TIMEOUT;
+	self->streaming=ZERO;
+	SDCARD_release(self);
+	return ret;
+}
+uint8_t SDCARD_wait_ready(SDCARD* self)
+{
+	uint32_t i;
+	for(i=ZERO;i<SDCARD_BUSY_RETRY;i++)
+		if(self->spi->fast_shift(SDCARD_DUMMY) == SDCARD_DUMMY)
+			return ONE;
+	return ZERO;
+}
+uint8_t SDCARD_command(SDCARD* self, uint8_t cmd, uint32_t arg)
+{
+	uint8_t frame[6];
+	uint8_t r1;
+	uint8_t i;
+	if(cmd & 0x80){
+		/***application specific command***/
+		cmd&=0x7F;
+		r1=SDCARD_command(self, CMD55, 0);
+		if(r1 > R1_IDLE)
+			return r1;
+	}
+	if(cmd != CMD12)
+		SDCARD_wait_ready(self);
+	frame[0]=0x40 | cmd;
+	frame[1]=(uint8_t)(arg>>24);
+	frame[2]=(uint8_t)(arg>>16);
+	frame[3]=(uint8_t)(arg>>8);
+	frame[4]=(uint8_t)arg;
+	switch(cmd){
+		case CMD0:
+			frame[5]=0x95;
+			break;
+		case CMD8:
+			frame[5]=0x87;
+			break;
+		default:
+			frame[5]=0x01;
+			break;
+	}
+	self->spi->transmit_sync(frame, 6);
+	if(cmd == CMD12)
+		self->spi->fast_shift(SDCARD_DUMMY); // stuff byte
+	for(i=ZERO;i<SDCARD_CMD_RETRY;i++){
+		r1=self->spi->fast_shift(SDCARD_DUMMY);
+		if(!(r1 & 0x80))
+			break;
+	}
+	return r1;
+}
+uint8_t SDCARD_receive(SDCARD* self, uint8_t* buffer)
+{
+	uint32_t i;
+	uint16_t n;
+	uint8_t token=SDCARD_DUMMY;
+	for(i=ZERO;i<SDCARD_TOKEN_RETRY && token == SDCARD_DUMMY;i++)
+		token=self->spi->fast_shift(SDCARD_DUMMY);
+	if(token != TOKEN_START_BLOCK)
+		return token == SDCARD_DUMMY ? SDCARD_ERROR_TIMEOUT : SDCARD_ERROR_DATA;
+	for(n=ZERO;n<SDCARD_BLOCK_SIZE;n+=SDCARD_CHUNK)
+		self->spi->transfer_sync(sdcard_dummy, buffer+n, SDCARD_CHUNK);
+	/***crc not checked***/
+	self->spi->fast_shift(SDCARD_DUMMY);
+	self->spi->fast_shift(SDCARD_DUMMY);
+	return SDCARD_OK;
+}
+uint8_t SDCARD_send(SDCARD* self, uint8_t token, const uint8_t* buffer)
+{
+	uint16_t n;
+	uint8_t response;
+	self->spi->fast_shift(token);
+	for(n=ZERO;n<SDCARD_BLOCK_SIZE;n+=SDCARD_CHUNK)
+		self->spi->transmit_sync((uint8_t*)(buffer+n), SDCARD_CHUNK);
+	/***dummy crc***/
+	self->spi->fast_shift(SDCARD_DUMMY);
+	self->spi->fast_shift(SDCARD_DUMMY);
+	response=self->spi->fast_shift(SDCARD_DUMMY);
+	if((response & DATA_RESPONSE_MASK) != DATA_ACCEPTED)
+		return SDCARD_ERROR_WRITE;
+	return SDCARD_OK;
+}
+void SDCARD_select(SDCARD* self)
+{
+	self->chipselect(ONE);
+}
+void SDCARD_release(SDCARD* self)
+{
+	self->chipselect(ZERO);
+	self->spi->fast_shift(SDCARD_DUMMY); // card releases MISO on next clock
+}
+uint32_t SDCARD_address(SDCARD* self, uint32_t lba)
+{
+	if(self->type == SDCARD_TYPE_SDHC)
+		return lba;
+	return lba << 9;
+}
+/***Interrupt***/
+/***Comment***
+Transmit and receive go through the SPI vtable in chunks of 128 bytes, received data overwrites the
+destination buffer while sdcard_dummy keeps MOSI high.
+*************/
+/***EOF***/
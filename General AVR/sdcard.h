@@ -0,0 +1,58 @@
+/************************************************************************
+	SDCARD
+Author: Sergio Santos
+	<sergio.salazar.santos@gmail.com>
+License: GNU General Public License
+Hardware: SD/MMC card in SPI mode
+Date: 17102026
+Comment:
+	Block driver on top of SPI vtable
+************************************************************************/
+#ifndef _SDCARD_H_
+	#define _SDCARD_H_
+/***Library***/
+#include <inttypes.h>
+#include "atmega128spi.h"
+/***Constant & Macro***/
+#define SDCARD_BLOCK_SIZE 512
+/***card type***/
+#define SDCARD_TYPE_NONE 0
+#define SDCARD_TYPE_MMC 1
+#define SDCARD_TYPE_SD1 2
+#define SDCARD_TYPE_SD2 3
+#define SDCARD_TYPE_SDHC 4
+/***return codes***/
+#define SDCARD_OK 0
+#define SDCARD_ERROR_TIMEOUT 1
+#define SDCARD_ERROR_CMD 2
+#define SDCARD_ERROR_DATA 3
+#define SDCARD_ERROR_WRITE 4
+#define SDCARD_ERROR_INIT 5
+/***Global Variable***/
+struct sdcard{
+	SPI* spi;
+	void (*chipselect)(uint8_t select); // 1 select card, 0 release
+	uint8_t type;
+	uint8_t streaming; // multiple block write open
+	/******/
+	uint8_t (*init)(struct sdcard* self);
+	uint8_t (*read_block)(struct sdcard* self, uint32_t lba, uint8_t* buffer);
+	uint8_t (*read_multi)(struct sdcard* self, uint32_t lba, uint8_t* buffer, uint16_t n);
+	uint8_t (*write_block)(struct sdcard* self, uint32_t lba, const uint8_t* buffer);
+	uint8_t (*write_multi)(struct sdcard* self, uint32_t lba, const uint8_t* buffer, uint16_t n);
+	uint8_t (*stream_start)(struct sdcard* self, uint32_t lba, uint32_t count);
+	uint8_t (*stream_write)(struct sdcard* self, const uint8_t* buffer);
+	uint8_t (*stream_stop)(struct sdcard* self);
+};
+typedef struct sdcard SDCARD;
+/***Header***/
+SDCARD SDCARDenable(SPI* spi, void (*chipselect)(uint8_t select));
+#endif
+/***Comment***
+Card must be initialized with SPI clock bellow 400KHz (prescaler 128 at 16Mhz), after init re-enable
+SPI with prescaler 2 for data transfer. Only the SPI vtable and the chip select callback are used, no
+register access, so the driver compiles for the PC with a SPI vtable that reads and writes a disk image.
+stream_start/stream_write/stream_stop keep one multiple block write open for sequential logging, count
+is sent as pre-erase hint (ACMD23) on SD cards.
+*************/
+/***EOF***/
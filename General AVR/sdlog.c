@@ -0,0 +1,207 @@
+/*************************************************************************
+	SDLOG
+Author: Sergio Santos
+	<sergio.salazar.santos@gmail.com>
+License: GNU General Public License
+Hardware: SD/MMC card in SPI mode
+Date: 17102026
+Comment:
+	Append only binary log on preallocated block region
+************************************************************************/
+/***Library***/
+#include <inttypes.h>
+#include <string.h>
+#include "sdlog.h"
+/***Constant & Macro***/
+#define ZERO 0
+#define ONE 1
+/***Global File Variable***/
+/***Header***/
+uint8_t SDLOG_format(SDLOG* self);
+uint8_t SDLOG_mount(SDLOG* self);
+uint16_t SDLOG_append(SDLOG* self, const void* data, uint16_t n);
+uint8_t SDLOG_sync(SDLOG* self);
+uint16_t SDLOG_read(SDLOG* self, uint32_t block, uint8_t* buffer);
+uint32_t SDLOG_size(SDLOG* self);
+uint8_t SDLOG_valid(SDLOG* self, struct sdlogheader* header, uint32_t block);
+uint8_t SDLOG_emit(SDLOG* self);
+uint8_t SDLOG_stop(SDLOG* self);
+/***Procedure & Function***/
+uint8_t SDLOGinit(SDLOG* self, SDCARD* card, uint32_t start, uint32_t nblock)
+// in place, the staging block is too big to build on the stack and copy out
+{
+	//import parametros
+	self->card=card;
+	self->start=start;
+	self->nblock=nblock;
+	//inic variables
+	self->generation=ZERO;
+	self->block=ZERO;
+	self->fill=ZERO;
+	self->written=ZERO;
+	self->status=SDLOG_ERROR_FORMAT;
+	//Direccionar apontadores para PROTOTIPOS
+	self->format=SDLOG_format;
+	self->mount=SDLOG_mount;
+	self->append=SDLOG_append;
+	self->sync=SDLOG_sync;
+	self->read=SDLOG_read;
+	self->size=SDLOG_size;
+	//
+	return nblock ? SDLOG_OK : SDLOG_ERROR_FORMAT;
+}
+uint8_t SDLOG_format(SDLOG* self)
+{
+	struct sdlogheader* header=(struct sdlogheader*)self->buffer;
+	uint16_t generation=ONE;
+	if(SDLOG_stop(self) != SDCARD_OK)
+		return (self->status=SDLOG_ERROR_CARD);
+	if(self->card->read_block(self->card, self->start, self->buffer) == SDCARD_OK)
+		if(header->magic == SDLOG_MAGIC)
+			generation=header->generation+ONE; // old blocks become invalid
+	memset(self->buffer, ZERO, SDCARD_BLOCK_SIZE);
+	header->magic=SDLOG_MAGIC;
+	header->generation=generation;
+	header->length=ZERO;
+	header->index=self->nblock;
+	if(self->card->write_block(self->card, self->start, self->buffer) != SDCARD_OK)
+		return (self->status=SDLOG_ERROR_CARD);
+	self->generation=generation;
+	self->block=ZERO;
+	self->fill=ZERO;
+	self->written=ZERO;
+	return (self->status=SDLOG_OK);
+}
+uint8_t SDLOG_mount(SDLOG* self)
+{
+	struct sdlogheader* header=(struct sdlogheader*)self->buffer;
+	uint32_t lo, hi, mid;
+	if(SDLOG_stop(self) != SDCARD_OK)
+		return (self->status=SDLOG_ERROR_CARD);
+	if(self->card->read_block(self->card, self->start, self->buffer) != SDCARD_OK)
+		return (self->status=SDLOG_ERROR_CARD);
+	if(header->magic != SDLOG_MAGIC || header->index != self->nblock)
+		return (self->status=SDLOG_ERROR_FORMAT);
+	self->generation=header->generation;
+	/***first invalid block***/
+	lo=ZERO;
+	hi=self->nblock;
+	while(lo < hi){
+		mid=lo+((hi-lo)>>1);
+		if(self->card->read_block(self->card, self->start+ONE+mid, self->buffer) != SDCARD_OK)
+			return (self->status=SDLOG_ERROR_CARD);
+		if(SDLOG_valid(self, header, mid))
+			lo=mid+ONE;
+		else
+			hi=mid;
+	}
+	self->block=lo;
+	self->fill=ZERO;
+	self->written=ZERO;
+	if(lo){
+		/***resume partial block***/
+		if(self->card->read_block(self->card, self->start+lo, self->buffer) != SDCARD_OK)
+			return (self->status=SDLOG_ERROR_CARD);
+		if(header->length < SDLOG_PAYLOAD){
+			self->block=lo-ONE;
+			self->fill=header->length;
+		}
+	}
+	if(self->block >= self->nblock)
+		return (self->status=SDLOG_FULL);
+	return (self->status=SDLOG_OK);
+}
+uint16_t SDLOG_append(SDLOG* self, const void* data, uint16_t n)
+{
+	const uint8_t* src=(const uint8_t*)data;
+	uint16_t count=ZERO;
+	uint16_t chunk;
+	while(n && self->status == SDLOG_OK){
+		chunk=SDLOG_PAYLOAD-self->fill;
+		if(chunk > n)
+			chunk=n;
+		memcpy(self->buffer+SDLOG_HEADER_SIZE+self->fill, src, chunk);
+		self->fill+=chunk;
+		src+=chunk;
+		count+=chunk;
+		n-=chunk;
+		if(self->fill == SDLOG_PAYLOAD)
+			SDLOG_emit(self);
+	}
+	return count;
+}
+uint8_t SDLOG_sync(SDLOG* self)
+{
+	struct sdlogheader* header=(struct sdlogheader*)self->buffer;
+	if(SDLOG_stop(self) != SDCARD_OK)
+		self->status=SDLOG_ERROR_CARD;
+	if(self->status != SDLOG_OK)
+		return self->status;
+	if(self->fill){
+		header->magic=SDLOG_MAGIC;
+		header->generation=self->generation;
+		header->length=self->fill;
+		header->index=self->block;
+		if(self->card->write_block(self->card, self->start+ONE+self->block, self->buffer) != SDCARD_OK)
+			self->status=SDLOG_ERROR_CARD;
+		else
+			self->written++;
+	}
+	return self->status;
+}
+uint16_t SDLOG_read(SDLOG* self, uint32_t block, uint8_t* buffer)
+{
+	struct sdlogheader* header=(struct sdlogheader*)buffer;
+	if(block >= self->nblock)
+		return ZERO;
+	if(SDLOG_stop(self) != SDCARD_OK){
+		self->status=SDLOG_ERROR_CARD;
+		return ZERO;
+	}
+	if(self->card->read_block(self->card, self->start+ONE+block, buffer) != SDCARD_OK)
+		return ZERO;
+	if(!SDLOG_valid(self, header, block))
+		return ZERO;
+	return header->length;
+}
+uint32_t SDLOG_size(SDLOG* self)
+{
+	return self->block*SDLOG_PAYLOAD+self->fill;
+}
+uint8_t SDLOG_valid(SDLOG* self, struct sdlogheader* header, uint32_t block)
+{
+	return header->magic == SDLOG_MAGIC && header->generation == self->generation &&
+		header->index == block && header->length && header->length <= SDLOG_PAYLOAD;
+}
+uint8_t SDLOG_emit(SDLOG* self)
+// send full staging block through open multiple block write
+{
+	struct sdlogheader* header=(struct sdlogheader*)self->buffer;
+	header->magic=SDLOG_MAGIC;
+	header->generation=self->generation;
+	header->length=SDLOG_PAYLOAD;
+	header->index=self->block;
+	if(!self->card->streaming){
+		if(self->card->stream_start(self->card, self->start+ONE+self->block, self->nblock-self->block) != SDCARD_OK)
+			return (self->status=SDLOG_ERROR_CARD);
+	}
+	if(self->card->stream_write(self->card, self->buffer) != SDCARD_OK)
+		return (self->status=SDLOG_ERROR_CARD);
+	self->written++;
+	self->block++;
+	self->fill=ZERO;
+	if(self->block >= self->nblock){
+		self->card->stream_stop(self->card);
+		self->status=SDLOG_FULL;
+	}
+	return self->status;
+}
+uint8_t SDLOG_stop(SDLOG* self)
+// close open multiple block write before any other command
+{
+	if(self->card->streaming)
+		return self->card->stream_stop(self->card);
+	return SDCARD_OK;
+}
+/***Interrupt***/
+/***EOF***/
@@ -0,0 +1,66 @@
+/************************************************************************
+	SDLOG
+Author: Sergio Santos
+	<sergio.salazar.santos@gmail.com>
+License: GNU General Public License
+Hardware: SD/MMC card in SPI mode
+Date: 17102026
+Comment:
+	Append only binary log on preallocated block region
+************************************************************************/
+#ifndef _SDLOG_H_
+	#define _SDLOG_H_
+/***Library***/
+#include <inttypes.h>
+#include "sdcard.h"
+/***Constant & Macro***/
+#define SDLOG_MAGIC 0x474F4C53UL // "SLOG"
+#define SDLOG_HEADER_SIZE 12
+#define SDLOG_PAYLOAD (SDCARD_BLOCK_SIZE - SDLOG_HEADER_SIZE)
+/***return codes***/
+#define SDLOG_OK 0
+#define SDLOG_ERROR_CARD 1
+#define SDLOG_ERROR_FORMAT 2
+#define SDLOG_FULL 3
+/***Global Variable***/
+struct sdlogheader{
+	uint32_t magic;
+	uint16_t generation; // incremented on every format
+	uint16_t length; // payload bytes in block
+	uint32_t index; // block index inside region
+};
+struct sdlog{
+	SDCARD* card;
+	uint32_t start; // superblock lba, data follows
+	uint32_t nblock; // preallocated data blocks
+	uint16_t generation;
+	uint32_t block; // block being filled
+	uint16_t fill; // payload bytes in staging buffer
+	uint32_t written; // blocks sent to card since mount
+	uint8_t status;
+	uint8_t buffer[SDCARD_BLOCK_SIZE]; // staging buffer
+	/******/
+	uint8_t (*format)(struct sdlog* self);
+	uint8_t (*mount)(struct sdlog* self);
+	uint16_t (*append)(struct sdlog* self, const void* data, uint16_t n);
+	uint8_t (*sync)(struct sdlog* self);
+	uint16_t (*read)(struct sdlog* self, uint32_t block, uint8_t* buffer);
+	uint32_t (*size)(struct sdlog* self);
+};
+typedef struct sdlog SDLOG;
+/***Header***/
+uint8_t SDLOGinit(SDLOG* self, SDCARD* card, uint32_t start, uint32_t nblock);
+#endif
+/***Comment***
+Region is one superblock followed by nblock data blocks, every data block starts with sdlogheader.
+Records are copied to a one block RAM staging buffer, full blocks go out through one open multiple
+block write so the card programs sequentially without per block command overhead. sync closes the
+stream and writes the partial block, the next append keeps filling it. mount finds the end of the log
+by binary search, valid blocks of the current generation are always a prefix of the region.
+read, mount and format close an open stream first, the card takes no other command inside CMD25, the
+next full block opens it again. Every SDLOG has its own staging block, keep it static or global, it is
+too big for the stack of a small part, and SDLOGinit sets it up in place instead of returning it by
+value, returns SDLOG_ERROR_FORMAT for an empty region. mount or format before append. Throughput is written*SDLOG_PAYLOAD bytes over the time base of
+the application, host/sdlogbench.c measures the SPI cost against the host/sdmock card.
+*************/
+/***EOF***/
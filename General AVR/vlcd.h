@@ -6,16 +6,18 @@ Software: AVR-GCC 4.1, AVR Libc 1.4
 Hardware: AVR with built-in ADC, tested on ATmega128 at 16 Mhz
 License:  GNU General Public License
 Comment:
-	  tested atemga 128 16Mhz, tested atemga 128 16Mhz, it works but not 
-	  advised because it uses stdlib.h malloc for structure and microcontrollers 
-	  do not like memory allocation, or mot e~well supported being glichy.
-	  Rather use other library it is better and supports two lcd connected.  
+	  tested atemga 128 16Mhz, descriptors come from a static pool of
+	  VLCD_POOL_SIZE displays and are passed by pointer, no malloc.
 ************************************************************************/
 #ifndef _VLCD_H_
 	#define _VLCD_H_
+#include <inttypes.h>
 /*
 ** constant and macro
 */
+#ifndef VLCD_POOL_SIZE
+	#define VLCD_POOL_SIZE 4
+#endif
 //ASIGN PORT PINS TO LCD (can be setup in any way)
 #define RS 0
 #define RW 1
@@ -35,22 +37,27 @@ struct parameter{
 	uint8_t detect;
 };
 struct vdisplay{
-	struct parameter *parameter;
+	struct parameter parameter;
 	/******/
-	void (*write)(struct vdisplay this, char c, unsigned short D_I);
-	char (*read)(struct vdisplay this, unsigned short D_I);
-	void (*BF)(struct vdisplay this);
-	void (*putch)(struct vdisplay this, char c);
-	char (*getch)(struct vdisplay this);
-	void (*string)(struct vdisplay this, const char *s);
-	void (*clear)(struct vdisplay this);
-	void (*gotoxy)(struct vdisplay this, unsigned int x, unsigned int y);
-	void (*reboot)(struct vdisplay this);
+	void (*write)(struct vdisplay* this, char c, unsigned short D_I);
+	char (*read)(struct vdisplay* this, unsigned short D_I);
+	void (*BF)(struct vdisplay* this);
+	void (*putch)(struct vdisplay* this, char c);
+	char (*getch)(struct vdisplay* this);
+	void (*string)(struct vdisplay* this, const char *s);
+	void (*clear)(struct vdisplay* this);
+	void (*gotoxy)(struct vdisplay* this, unsigned int x, unsigned int y);
+	void (*reboot)(struct vdisplay* this);
 };
 typedef struct vdisplay VLCD;
 /*
 ** procedure and function header
 */
-VLCD VLCDenable(volatile uint8_t *ddr, volatile uint8_t *pin, volatile uint8_t *port);
+VLCD* VLCDenable(volatile uint8_t *ddr, volatile uint8_t *pin, volatile uint8_t *port);
 #endif
+/*
+** comment
+VLCDenable takes the next free descriptor of the pool and returns 0 when all VLCD_POOL_SIZE are in use,
+every call goes through the pointer, lcd->putch(lcd, c), nothing is copied.
+*/
 /***EOF***/
@@ -13,7 +13,9 @@ Comment:
 	#define F_CPU 16000000UL
 #endif
 /***Library***/
-#include <avr/io.h>
+#ifdef __AVR__
+	#include <avr/io.h>
+#endif
 #include <inttypes.h>
 #include "znpid.h"
 /***Constant & Macro***/
@@ -47,9 +49,11 @@ float ZNPID_output(ZNPID* self, float PV, float timelapse);
 ZNPID ZNPIDenable(void)
 {
 	//LOCAL VARIABLES
+	#ifdef __AVR__
 	uint8_t tSREG;
 	tSREG=SREG;
 	SREG&=~(1<<GLOBAL_INTERRUPT_ENABLE);
+	#endif
 	//ALLOCAÇÂO MEMORIA PARA Estrutura
 	ZNPID znpid;
 	//import parametros
@@ -71,7 +75,9 @@ ZNPID ZNPIDenable(void)
 	znpid.set_kd=ZNPID_set_kd;
 	znpid.set_SP=ZNPID_set_SP;
 	znpid.output=ZNPID_output;
+	#ifdef __AVR__
 	SREG=tSREG;
+	#endif
 	//
 	return znpid;
 }
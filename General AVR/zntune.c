@@ -0,0 +1,149 @@
+/*************************************************************************
+	ZNTUNE
+Author: Sergio Santos
+	<sergio.salazar.santos@gmail.com>
+License: GNU General Public License
+Hardware: all
+Date: 17102026
+Comment:
+	Relay auto tuning for ZNPID, Ziegler Nichols ultimate gain and period
+************************************************************************/
+/***Library***/
+#include <inttypes.h>
+#include <math.h>
+#include "zntune.h"
+/***Constant & Macro***/
+#define ZERO 0
+#define ONE 1
+#define ZNTUNE_PI_VALUE 3.14159265f
+/***Global File Variable***/
+/***Header***/
+void ZNTUNE_start(ZNTUNE* self);
+float ZNTUNE_step(ZNTUNE* self, float PV, float timelapse);
+uint8_t ZNTUNE_apply(ZNTUNE* self, uint8_t rule);
+void ZNTUNE_finish(ZNTUNE* self);
+/***Procedure & Function***/
+ZNTUNE ZNTUNEenable(ZNPID* pid, float bias, float amplitude, float hysteresis, uint8_t cycles, float timeout)
+{
+	//ALLOCAÇÂO MEMORIA PARA Estrutura
+	ZNTUNE zntune;
+	//import parametros
+	zntune.pid=pid;
+	zntune.bias=bias;
+	zntune.amplitude=amplitude;
+	zntune.hysteresis=hysteresis;
+	zntune.cycles=cycles ? cycles : ONE;
+	zntune.timeout=timeout;
+	//inic variables
+	zntune.status=ZNTUNE_IDLE;
+	zntune.high=ONE;
+	zntune.count=ZERO;
+	zntune.time=ZERO;
+	zntune.last=ZERO;
+	zntune.max=ZERO;
+	zntune.min=ZERO;
+	zntune.sum_period=ZERO;
+	zntune.sum_amplitude=ZERO;
+	zntune.ku=ZERO;
+	zntune.tu=ZERO;
+	//Direccionar apontadores para PROTOTIPOS
+	zntune.start=ZNTUNE_start;
+	zntune.step=ZNTUNE_step;
+	zntune.apply=ZNTUNE_apply;
+	//
+	return zntune;
+}
+void ZNTUNE_start(ZNTUNE* self)
+{
+	self->status=ZNTUNE_RUNNING;
+	self->high=ONE;
+	self->count=ZERO;
+	self->time=ZERO;
+	self->last=-ONE; // no switch to high yet
+	self->max=self->pid->SetPoint;
+	self->min=self->pid->SetPoint;
+	self->sum_period=ZERO;
+	self->sum_amplitude=ZERO;
+}
+float ZNTUNE_step(ZNTUNE* self, float PV, float timelapse)
+{
+	float SP=self->pid->SetPoint;
+	if(self->status != ZNTUNE_RUNNING)
+		return self->bias;
+	self->time+=timelapse;
+	self->pid->PV=PV;
+	if(PV > self->max)
+		self->max=PV;
+	if(PV < self->min)
+		self->min=PV;
+	if(self->high){
+		if(PV > SP+self->hysteresis)
+			self->high=ZERO;
+	}else if(PV < SP-self->hysteresis){
+		/***one full period ends at every switch to high***/
+		self->high=ONE;
+		if(self->last >= ZERO){
+			if(self->count){
+				self->sum_period+=self->time-self->last;
+				self->sum_amplitude+=(self->max-self->min)/2;
+			}
+			if(self->count++ == self->cycles){
+				ZNTUNE_finish(self);
+				return self->bias;
+			}
+		}
+		self->last=self->time;
+		self->max=PV;
+		self->min=PV;
+	}
+	if(self->time > self->timeout){
+		self->status=ZNTUNE_FAIL;
+		return self->bias;
+	}
+	self->pid->OP=self->high ? self->bias+self->amplitude : self->bias-self->amplitude;
+	return self->pid->OP;
+}
+uint8_t ZNTUNE_apply(ZNTUNE* self, uint8_t rule)
+{
+	float kc, ti, td;
+	if(self->status != ZNTUNE_DONE)
+		return ZERO;
+	switch(rule){
+		case ZNTUNE_PI:
+			kc=0.45f*self->ku;
+			ti=self->tu/1.2f;
+			td=ZERO;
+			break;
+		case ZNTUNE_NO_OVERSHOOT:
+			kc=0.2f*self->ku;
+			ti=self->tu/2;
+			td=self->tu/3;
+			break;
+		default:
+			kc=0.6f*self->ku;
+			ti=self->tu/2;
+			td=self->tu/8;
+			break;
+	}
+	self->pid->set_kc(self->pid, kc);
+	self->pid->set_ki(self->pid, kc/ti);
+	self->pid->set_kd(self->pid, kc*td);
+	self->pid->integral=ZERO;
+	self->pid->Err_past=self->pid->SetPoint-self->pid->PV;
+	return ONE;
+}
+void ZNTUNE_finish(ZNTUNE* self)
+// Ku from describing function of relay with hysteresis
+{
+	float a=self->sum_amplitude/self->cycles;
+	float h=self->hysteresis;
+	self->tu=self->sum_period/self->cycles;
+	if(a <= h){
+		self->status=ZNTUNE_FAIL;
+		return;
+	}
+	self->ku=4*self->amplitude/(ZNTUNE_PI_VALUE*sqrtf(a*a-h*h));
+	self->status=ZNTUNE_DONE;
+}
+/***Interrupt***/
+/***EOF***/
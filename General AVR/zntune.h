@@ -0,0 +1,64 @@
+/************************************************************************
+	ZNTUNE
+Author: Sergio Santos
+	<sergio.salazar.santos@gmail.com>
+License: GNU General Public License
+Hardware: all
+Date: 17102026
+Comment:
+	Relay auto tuning for ZNPID, Ziegler Nichols ultimate gain and period
+************************************************************************/
+#ifndef _ZNTUNE_H_
+	#define _ZNTUNE_H_
+/***Library***/
+#include <inttypes.h>
+#include "znpid.h"
+/***Constant & Macro***/
+/***status***/
+#define ZNTUNE_IDLE 0
+#define ZNTUNE_RUNNING 1
+#define ZNTUNE_DONE 2
+#define ZNTUNE_FAIL 3
+/***rules***/
+#define ZNTUNE_PID 0 // classic, kc 0.6Ku Ti Tu/2 Td Tu/8
+#define ZNTUNE_PI 1 // kc 0.45Ku Ti Tu/1.2
+#define ZNTUNE_NO_OVERSHOOT 2 // kc 0.2Ku Ti Tu/2 Td Tu/3
+/***Global Variable***/
+struct zntune{
+	ZNPID* pid;
+	float bias; // relay center output
+	float amplitude; // relay swing d, output is bias+d or bias-d
+	float hysteresis; // PV band around set point
+	float timeout; // seconds
+	uint8_t cycles; // periods averaged
+	uint8_t status;
+	uint8_t high; // relay state
+	uint8_t count; // finished periods, first one discarded
+	float time;
+	float last; // time of last switch to high
+	float max;
+	float min;
+	float sum_period;
+	float sum_amplitude;
+	float ku; // ultimate gain
+	float tu; // ultimate period, seconds
+	/******/
+	void (*start)(struct zntune* self);
+	float (*step)(struct zntune* self, float PV, float timelapse);
+	uint8_t (*apply)(struct zntune* self, uint8_t rule);
+};
+typedef struct zntune ZNTUNE;
+/***Header***/
+ZNTUNE ZNTUNEenable(ZNPID* pid, float bias, float amplitude, float hysteresis, uint8_t cycles, float timeout);
+#endif
+/***Comment***
+start then call step instead of ZNPID output every control period, it returns the relay output and
+never blocks. The relay switches to bias-d when PV rises above SetPoint+hysteresis and to bias+d when
+it falls below SetPoint-hysteresis, the loop settles into a limit cycle at the ultimate frequency.
+Every period between switches to high is timed and the PV peaks give the oscillation amplitude a, the
+first period is discarded, after cycles periods Ku=4d/(pi*sqrt(a*a-h*h)) and Tu is the mean period and
+status is ZNTUNE_DONE. No oscillation within timeout is ZNTUNE_FAIL. apply sets kc, ki and kd of the
+ZNPID by the chosen rule, ki=kc/Ti and kd=kc*Td as used by ZNPID output. Choose d so the swing is
+safe for the process and hysteresis above the PV noise.
+*************/
+/***EOF***/
@@ -37,12 +37,61 @@ Comment:
 #else
 	#error "Not Atmega 128"
 #endif
+#define SPI_QUEUE_MASK (SPI_QUEUE_SIZE - 1)
+#if ( SPI_QUEUE_SIZE & SPI_QUEUE_MASK )
+	#error SPI queue size is not a power of 2
+#endif
+#define SPI_DUMMY 0xFF
+#define SPI_RX_BUFFER_MASK (SPI_RX_BUFFER_SIZE - 1)
+#define SPI_TX_BUFFER_MASK (SPI_TX_BUFFER_SIZE - 1)
+#define SPI_FRAME_QUEUE_MASK (SPI_FRAME_QUEUE_SIZE - 1)
+#if ( SPI_RX_BUFFER_SIZE & SPI_RX_BUFFER_MASK )
+	#error SPI RX buffer size is not a power of 2
+#endif
+#if ( SPI_TX_BUFFER_SIZE & SPI_TX_BUFFER_MASK )
+	#error SPI TX buffer size is not a power of 2
+#endif
+#if ( SPI_FRAME_QUEUE_SIZE & SPI_FRAME_QUEUE_MASK )
+	#error SPI frame queue size is not a power of 2
+#endif
 /***Global File Variables***/
+static struct spi_transfer* volatile spi_queue_buf[SPI_QUEUE_SIZE];
+static volatile uint8_t spi_queue_head;
+static volatile uint8_t spi_queue_tail;
+static volatile uint16_t spi_index;
+static volatile uint8_t spi_running;
+static uint8_t spi_prescaler;
+/***slave***/
+static volatile uint8_t SPI_RxBuf[SPI_RX_BUFFER_SIZE];
+static volatile uint8_t SPI_TxBuf[SPI_TX_BUFFER_SIZE];
+static volatile uint8_t SPI_RxHead;
+static volatile uint8_t SPI_RxTail;
+static volatile uint8_t SPI_TxHead;
+static volatile uint8_t SPI_TxTail;
+static volatile uint8_t SPI_FrameBuf[SPI_FRAME_QUEUE_SIZE];
+static volatile uint8_t SPI_FrameHead;
+static volatile uint8_t SPI_FrameTail;
+static volatile uint8_t SPI_FrameMark;
+static volatile uint8_t SPI_Select;
+static volatile uint8_t SPI_FrameOver; // frame longer than the rx ring
+static volatile uint8_t SPI_TxPreload; // SPDR holds idle byte, next putc replaces it
+static volatile uint16_t SPI_LastError;
 /***Header***/
 void spi_default(void);
 void spi_transfer_sync (uint8_t * dataout, uint8_t * datain, uint8_t len);
 void spi_transmit_sync (uint8_t * dataout, uint8_t len);
 uint8_t spi_fast_shift (uint8_t data);
+uint8_t spi_queue(struct spi_transfer* transfer);
+uint8_t spi_busy(void);
+void spi_flush(void);
+void spi_poll(struct spi_transfer* transfer);
+void spi_start(void);
+uint16_t spi_slave_getc(void);
+uint8_t spi_slave_putc(uint8_t data);
+uint8_t spi_slave_available(void);
+void spi_slave_select(void);
+uint8_t spi_slave_frame(void);
+uint16_t spi_slave_error(void);
 /***Procedure & function***/
 SPI SPIenable(uint8_t master_slave_select, uint8_t data_order,  uint8_t data_modes, uint8_t prescaler)
 {
@@ -50,6 +99,26 @@ SPI SPIenable(uint8_t master_slave_select, uint8_t data_order,  uint8_t data_mod
 	spi.transfer_sync = spi_transfer_sync;
 	spi.transmit_sync = spi_transmit_sync;
 	spi.fast_shift = spi_fast_shift;
+	spi.queue = spi_queue;
+	spi.busy = spi_busy;
+	spi.flush = spi_flush;
+	spi.slave_getc = spi_slave_getc;
+	spi.slave_putc = spi_slave_putc;
+	spi.slave_available = spi_slave_available;
+	spi.slave_select = spi_slave_select;
+	spi.slave_frame = spi_slave_frame;
+	spi.slave_error = spi_slave_error;
+	SPI_RxHead = SPI_RxTail = 0;
+	SPI_TxHead = SPI_TxTail = 0;
+	SPI_FrameHead = SPI_FrameTail = SPI_FrameMark = 0;
+	SPI_Select = 0;
+	SPI_FrameOver = 0;
+	SPI_TxPreload = 1;
+	SPI_LastError = 0;
+	spi_queue_head = 0;
+	spi_queue_tail = 0;
+	spi_running = 0;
+	spi_prescaler = prescaler;
 	/***/
 	SPI_DDR &= ~((1<<DD_MOSI)|(1<<DD_MISO)|(1<<DD_SS)|(1<<DD_SCK));
 	switch(master_slave_select){
@@ -59,7 +128,8 @@ SPI SPIenable(uint8_t master_slave_select, uint8_t data_order,  uint8_t data_mod
 			SPI_PORT |= (1<<DD_SS);
 			break;
 		case SPI_SLAVE_MODE:
-			SPI_CONTROL_REGISTER |= (1<<MSTR);
+			SPI_CONTROL_REGISTER &= ~(1<<MSTR);
+			SPI_CONTROL_REGISTER |= (1<<SPIE);
 			SPI_DDR |= (1<<DD_MISO);
 			break;
 		default:
@@ -127,9 +197,12 @@ SPI SPIenable(uint8_t master_slave_select, uint8_t data_order,  uint8_t data_mod
 		default:
 			SPI_STATUS_REGISTER |= (1<<SPI2X);
 			SPI_CONTROL_REGISTER |= (1<<SPR0);
+			spi_prescaler = 8;
 			break;
 	}
 	SPI_CONTROL_REGISTER |= (1<<SPE);
+	if(master_slave_select == SPI_SLAVE_MODE)
+		SPI_DATA_REGISTER = SPI_SLAVE_IDLE;
 	return spi;
 }
 void spi_default()
@@ -174,6 +247,285 @@ uint8_t spi_fast_shift (uint8_t data)
 		; // polling, serial transfer is complete interrupt.
     return SPI_DATA_REGISTER;
 }
+uint8_t spi_queue(struct spi_transfer* transfer)
+// Queue transfer descriptor, returns 0 if queue is full
+{
+	uint8_t tSREG;
+	#ifndef SPI_SLAVE_ISR
+	uint8_t tmphead;
+	#endif
+	tSREG=SREG;
+	SREG&=~(1<<GLOBAL_INTERRUPT_ENABLE);
+	#ifdef SPI_SLAVE_ISR
+	// no master interrupt, one polled transfer at a time
+	if(spi_running){
+		SREG=tSREG;
+		return 0;
+	}
+	spi_running = 1;
+	SREG=tSREG;
+	spi_poll(transfer);
+	spi_running = 0;
+	return 1;
+	#else
+	if(!spi_running && spi_prescaler <= SPI_POLL_PRESCALER){
+		// bus idle and fast clock, cheaper to poll than to interrupt
+		spi_running = 1; // transfers queued meanwhile wait in the queue
+		SREG=tSREG;
+		spi_poll(transfer);
+		SREG&=~(1<<GLOBAL_INTERRUPT_ENABLE);
+		spi_start(); // clears spi_running if nothing was queued during the poll
+		SREG=tSREG;
+		return 1;
+	}
+	tmphead = (spi_queue_head + 1) & SPI_QUEUE_MASK;
+	if(tmphead == spi_queue_tail){
+		SREG=tSREG;
+		return 0;
+	}
+	transfer->status = SPI_TRANSFER_PENDING;
+	spi_queue_buf[spi_queue_head] = transfer;
+	spi_queue_head = tmphead;
+	if(!spi_running)
+		spi_start();
+	SREG=tSREG;
+	return 1;
+	#endif
+}
+uint8_t spi_busy(void)
+// Transfers pending or running
+{
+	return spi_running;
+}
+void spi_flush(void)
+// Wait for queue to drain
+{
+	while(spi_running)
+		;
+}
+void spi_poll(struct spi_transfer* transfer)
+// Unrolled polled transfer, next byte is loaded as soon as SPIF rises
+{
+	uint8_t* out = transfer->dataout;
+	uint8_t* in = transfer->datain;
+	uint16_t n = transfer->len;
+	uint8_t c;
+	transfer->status = SPI_TRANSFER_ACTIVE;
+	if(transfer->chipselect)
+		transfer->chipselect(1);
+	if(out && in){
+		for(; n >= 2; n -= 2){
+			SPI_DATA_REGISTER = *out++;
+			while(!(SPI_STATUS_REGISTER & (1<<SPIF)));
+			*in++ = SPI_DATA_REGISTER;
+			SPI_DATA_REGISTER = *out++;
+			while(!(SPI_STATUS_REGISTER & (1<<SPIF)));
+			*in++ = SPI_DATA_REGISTER;
+		}
+		if(n){
+			SPI_DATA_REGISTER = *out;
+			while(!(SPI_STATUS_REGISTER & (1<<SPIF)));
+			*in = SPI_DATA_REGISTER;
+		}
+	}else if(out){
+		for(; n >= 2; n -= 2){
+			SPI_DATA_REGISTER = *out++;
+			c = *out++;
+			while(!(SPI_STATUS_REGISTER & (1<<SPIF)));
+			SPI_DATA_REGISTER = c;
+			while(!(SPI_STATUS_REGISTER & (1<<SPIF)));
+		}
+		if(n){
+			SPI_DATA_REGISTER = *out;
+			while(!(SPI_STATUS_REGISTER & (1<<SPIF)));
+		}
+		c = SPI_DATA_REGISTER; // clear SPIF
+	}else{
+		for(; n; n--){
+			SPI_DATA_REGISTER = SPI_DUMMY;
+			while(!(SPI_STATUS_REGISTER & (1<<SPIF)));
+			c = SPI_DATA_REGISTER;
+			if(in)
+				*in++ = c;
+		}
+	}
+	if(transfer->chipselect)
+		transfer->chipselect(0);
+	transfer->status = SPI_TRANSFER_DONE;
+}
+void spi_start(void)
+// Select device and load first byte of transfer at queue tail, interrupts disabled
+{
+	struct spi_transfer* transfer;
+	while(spi_queue_tail != spi_queue_head){
+		transfer = spi_queue_buf[spi_queue_tail];
+		transfer->status = SPI_TRANSFER_ACTIVE;
+		if(transfer->chipselect)
+			transfer->chipselect(1);
+		if(transfer->len){
+			spi_index = 0;
+			spi_running = 1;
+			SPI_CONTROL_REGISTER |= (1<<SPIE);
+			SPI_DATA_REGISTER = transfer->dataout ? transfer->dataout[0] : SPI_DUMMY;
+			return;
+		}
+		if(transfer->chipselect)
+			transfer->chipselect(0);
+		transfer->status = SPI_TRANSFER_DONE;
+		spi_queue_tail = (spi_queue_tail + 1) & SPI_QUEUE_MASK;
+	}
+	spi_running = 0;
+	SPI_CONTROL_REGISTER &= ~(1<<SPIE);
+}
+uint16_t spi_slave_getc(void)
+// Received byte, SPI_NO_DATA if rx buffer is empty
+{
+	uint8_t data;
+	if(SPI_RxHead == SPI_RxTail)
+		return SPI_NO_DATA;
+	data = SPI_RxBuf[SPI_RxTail];
+	SPI_RxTail = (SPI_RxTail + 1) & SPI_RX_BUFFER_MASK;
+	return data;
+}
+uint8_t spi_slave_putc(uint8_t data)
+// Queue reply byte, returns 0 if tx buffer is full
+{
+	uint8_t tSREG;
+	uint8_t tmphead;
+	tSREG=SREG;
+	SREG&=~(1<<GLOBAL_INTERRUPT_ENABLE);
+	if(SPI_TxPreload && !SPI_Select){
+		// first byte of next frame goes straight to the shift register
+		SPI_DATA_REGISTER = data;
+		SPI_TxPreload = 0;
+		SREG=tSREG;
+		return 1;
+	}
+	tmphead = (SPI_TxHead + 1) & SPI_TX_BUFFER_MASK;
+	if(tmphead == SPI_TxTail){
+		SREG=tSREG;
+		return 0;
+	}
+	SPI_TxBuf[SPI_TxHead] = data;
+	SPI_TxHead = tmphead;
+	SREG=tSREG;
+	return 1;
+}
+uint8_t spi_slave_available(void)
+// Bytes waiting in rx buffer
+{
+	return (SPI_RxHead - SPI_RxTail) & SPI_RX_BUFFER_MASK;
+}
+void spi_slave_select(void)
+// Call on SS change, closes frame on rising edge
+{
+	uint8_t tSREG;
+	uint8_t tmphead;
+	tSREG=SREG;
+	SREG&=~(1<<GLOBAL_INTERRUPT_ENABLE);
+	if(SPI_PIN & (1<<DD_SS)){
+		if(SPI_Select){
+			SPI_Select = 0;
+			tmphead = (SPI_FrameHead + 1) & SPI_FRAME_QUEUE_MASK;
+			if(SPI_FrameOver){
+				SPI_FrameOver = 0; // length wrapped in the ring, not queued
+				SPI_LastError |= SPI_FRAME_OVERFLOW;
+			}else if(tmphead == SPI_FrameTail){
+				SPI_LastError |= SPI_BUFFER_OVERFLOW;
+			}else{
+				SPI_FrameBuf[SPI_FrameHead] = (SPI_RxHead - SPI_FrameMark) & SPI_RX_BUFFER_MASK;
+				SPI_FrameHead = tmphead;
+			}
+			SPI_FrameMark = SPI_RxHead;
+			/***replies not clocked out belong to the closed frame***/
+			SPI_TxTail = SPI_TxHead;
+			SPI_DATA_REGISTER = SPI_SLAVE_IDLE;
+			SPI_TxPreload = 1;
+		}
+	}else{
+		SPI_Select = 1;
+		SPI_FrameOver = 0;
+		SPI_FrameMark = SPI_RxHead;
+	}
+	SREG=tSREG;
+}
+uint8_t spi_slave_frame(void)
+// Length of oldest complete frame, 0 if none
+{
+	uint8_t len;
+	if(SPI_FrameHead == SPI_FrameTail)
+		return 0;
+	len = SPI_FrameBuf[SPI_FrameTail];
+	SPI_FrameTail = (SPI_FrameTail + 1) & SPI_FRAME_QUEUE_MASK;
+	return len;
+}
+uint16_t spi_slave_error(void)
+// Error flags since last call
+{
+	uint16_t error;
+	uint8_t tSREG;
+	tSREG=SREG;
+	SREG&=~(1<<GLOBAL_INTERRUPT_ENABLE);
+	error = SPI_LastError;
+	SPI_LastError = 0;
+	SREG=tSREG;
+	return error;
+}
 /***Interrupt***/
-ISR(SPI_STC_vect){ }
+#define SPI_SLAVE_SERVICE(c) \
+	do{ \
+		uint8_t tmp = SPI_TxTail; \
+		if(tmp != SPI_TxHead){ \
+			SPI_DATA_REGISTER = SPI_TxBuf[tmp]; \
+			SPI_TxTail = (tmp + 1) & SPI_TX_BUFFER_MASK; \
+		}else \
+			SPI_DATA_REGISTER = SPI_SLAVE_IDLE; \
+		if(SPI_STATUS_REGISTER & (1<<WCOL)) \
+			SPI_LastError |= SPI_WRITE_COLLISION; \
+		tmp = (SPI_RxHead + 1) & SPI_RX_BUFFER_MASK; \
+		if(tmp == SPI_RxTail){ \
+			SPI_LastError |= SPI_BUFFER_OVERFLOW; \
+		}else{ \
+			SPI_RxBuf[SPI_RxHead] = (c); \
+			SPI_RxHead = tmp; \
+			if(tmp == SPI_FrameMark && SPI_Select) \
+				SPI_FrameOver = 1; \
+		} \
+		SPI_TxPreload = 0; \
+	}while(0)
+#ifdef SPI_SLAVE_ISR
+ISR(SPI_STC_vect)
+// slave only, no calls so the prologue saves only the registers used here
+{
+	uint8_t c = SPI_DATA_REGISTER;
+	SPI_SLAVE_SERVICE(c);
+}
+#else
+ISR(SPI_STC_vect)
+{
+	struct spi_transfer* transfer;
+	uint16_t index;
+	uint8_t c = SPI_DATA_REGISTER;
+	if(!(SPI_CONTROL_REGISTER & (1<<MSTR))){
+		/***slave, reload reply first***/
+		SPI_SLAVE_SERVICE(c);
+		return;
+	}
+	transfer = spi_queue_buf[spi_queue_tail];
+	index = spi_index;
+	if(transfer->datain)
+		transfer->datain[index] = c;
+	index++;
+	if(index < transfer->len){
+		SPI_DATA_REGISTER = transfer->dataout ? transfer->dataout[index] : SPI_DUMMY;
+		spi_index = index;
+	}else{
+		if(transfer->chipselect)
+			transfer->chipselect(0);
+		transfer->status = SPI_TRANSFER_DONE;
+		spi_queue_tail = (spi_queue_tail + 1) & SPI_QUEUE_MASK;
+		spi_start();
+	}
+}
+#endif
 /***EOF***/
@@ -21,15 +21,93 @@ Comment:
 #define SPI_MSB_DATA_ORDER 0
 #define SPI_MASTER_MODE 1
 #define SPI_SLAVE_MODE 0
+/***Transfer queue size, must be power of 2***/
+#ifndef SPI_QUEUE_SIZE
+	#define SPI_QUEUE_SIZE 8
+#endif
+/***Clock divisors up to this value are polled, master ISR longer than a byte, see Comment***/
+#ifndef SPI_POLL_PRESCALER
+	#define SPI_POLL_PRESCALER 16
+#endif
+/***Size of the slave circular buffers, must be power of 2***/
+#ifndef SPI_RX_BUFFER_SIZE
+	#define SPI_RX_BUFFER_SIZE 64
+#endif
+#ifndef SPI_TX_BUFFER_SIZE
+	#define SPI_TX_BUFFER_SIZE 64
+#endif
+#ifndef SPI_FRAME_QUEUE_SIZE
+	#define SPI_FRAME_QUEUE_SIZE 8
+#endif
+/***slave only build, lean interrupt without the master queue***/
+//#define SPI_SLAVE_ISR
+/***byte clocked out by slave when tx buffer is empty***/
+#ifndef SPI_SLAVE_IDLE
+	#define SPI_SLAVE_IDLE 0xFF
+#endif
+/***high byte of slave_getc, and slave_error flags***/
+#define SPI_NO_DATA 0x0100
+#define SPI_BUFFER_OVERFLOW 0x0200
+#define SPI_WRITE_COLLISION 0x0400
+#define SPI_FRAME_OVERFLOW 0x0800
+/***transfer status***/
+#define SPI_TRANSFER_IDLE 0
+#define SPI_TRANSFER_PENDING 1
+#define SPI_TRANSFER_ACTIVE 2
+#define SPI_TRANSFER_DONE 3
 /***Global Variable***/
+struct spi_transfer{
+	void (*chipselect)(uint8_t select); // 1 select device, 0 release, NULL if none
+	uint8_t* dataout; // NULL clocks out 0xFF
+	uint8_t* datain; // NULL discards received bytes
+	uint16_t len;
+	volatile uint8_t status;
+};
 struct sp{
 	/***/
 	void (*transfer_sync) (uint8_t * dataout, uint8_t * datain, uint8_t len);
 	void (*transmit_sync) (uint8_t * dataout, uint8_t len);
 	uint8_t (*fast_shift) (uint8_t data);
+	uint8_t (*queue) (struct spi_transfer* transfer);
+	uint8_t (*busy) (void);
+	void (*flush) (void);
+	/***slave***/
+	uint16_t (*slave_getc) (void);
+	uint8_t (*slave_putc) (uint8_t data);
+	uint8_t (*slave_available) (void);
+	void (*slave_select) (void);
+	uint8_t (*slave_frame) (void);
+	uint16_t (*slave_error) (void);
 };
 typedef struct sp SPI;
 /***Header***/
 SPI SPIenable(uint8_t master_slave_select, uint8_t data_order,  uint8_t data_modes, uint8_t prescaler);
 #endif
+/***Comment***
+Slave mode is serviced by the SPI STC interrupt into RX and TX rings. Frames are delimited by SS, wire
+SS (PB0) also to a free INTn with any logical change sense and call slave_select from that ISR in main,
+slave_frame then returns the byte count of the oldest complete frame. At the end of a frame replies
+not yet clocked out are dropped, the first slave_putc after it loads SPDR directly so the reply starts
+on the first byte of the next frame. A frame of more than SPI_RX_BUFFER_SIZE-1 bytes is not queued,
+slave_error reports SPI_FRAME_OVERFLOW, drain the ring with slave_getc to get back in step. Define
+SPI_SLAVE_ISR for a slave only build, the interrupt then has no calls and a short prologue and
+spi_queue polls one transfer at a time.
+Slave timing, counted by instruction timing and not measured: with SPI_SLAVE_ISR the reply is written
+to SPDR about 40 cycles after SPIF (7 response and vector, about 18 prologue, about 15 to fetch it) and
+the interrupt takes about 95 cycles, the shared interrupt also saves the call clobbered registers and
+takes about 65 and 145 cycles. The slave has one transmit buffer, the reply is in place only if the
+host leaves at least the reply time between bytes, and the ring keeps up only if a byte plus its gap
+is longer than the interrupt. The maximum slave clock fosc/4 (32 cycles a byte) therefore needs host
+side gaps of about 65 cycles (4us at 16MHz) with SPI_SLAVE_ISR and 115 cycles (7us) with the shared
+interrupt. Back to back bytes give stale replies at any clock and are received without overrun only
+at fosc/16 or lower with SPI_SLAVE_ISR, fosc/32 with the shared interrupt. Add the longest time
+interrupts are disabled elsewhere to every figure.
+SPI_POLL_PRESCALER is set from the master interrupt counted by instruction timing, not measured: 7
+cycles response and vector jump, about 35 of prologue (SREG, RAMPZ and the 12 call clobbered registers
+saved because of the chipselect and spi_start calls), about 55 of body for a middle byte of the
+transfer (descriptor, 16 bit index, datain store, len compare, dataout load) and about 38 of epilogue
+and reti, some 135 cycles a byte. A byte takes 8*prescaler cycles, 128 at fosc/16, so up to 16 the
+interrupt would take all of the CPU and the bus would stand idle while it runs, polling is faster and
+costs the same CPU. At fosc/32 (256 cycles) interrupts give back about half of the CPU.
+*************/
 /***EOF***/